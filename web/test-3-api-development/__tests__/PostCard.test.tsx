@@ -5,14 +5,16 @@ import { mockPosts, mockUsers } from '@/utils/mockData';
 
 // Mock the stores
 jest.mock('@/store/users', () => ({
-  useUserStore: () => ({
+  useUserStore: (selector: (state: any) => any) => selector({
     currentUser: mockUsers[0],
   }),
 }));
 
+const mockLikePost = jest.fn();
+
 jest.mock('@/store/posts', () => ({
-  usePostsStore: () => ({
-    likePost: jest.fn(),
+  usePostsStore: (selector: (state: any) => any) => selector({
+    likePost: mockLikePost,
   }),
 }));
 
@@ -73,8 +75,14 @@ describe('PostCard', () => {
     expect(mockOnEdit).toHaveBeenCalledWith(mockPost);
   });
 
+  it('likes the post as the current user', () => {
+    renderWithChakra(<PostCard post={mockPost} />);
+
+    fireEvent.click(screen.getByRole('button', { name: String(mockPost.likes) }));
+    expect(mockLikePost).toHaveBeenCalledWith(mockPost.id, mockUsers[0].id);
+  });
+
   // TODO: Add more tests
-  // - Test like functionality
   // - Test responsive design
   // - Test accessibility
   // - Test error states
@@ -0,0 +1,97 @@
+/**
+ * @jest-environment node
+ */
+import batchHandler from '@/pages/api/posts/batch';
+import { PostRepository, setPostRepository } from '@/server/postRepository';
+import { postsApi, responseCache } from '@/utils/api';
+import { mockPosts } from '@/utils/mockData';
+import { createRequest, createResponse } from '@/benchmarks/harness';
+import { PostBatch } from '@/types';
+
+// Answers every fetch() with the URL it was called with
+function mockFetch() {
+  const fetchMock = jest.fn(async (url: string) => {
+    const res = createResponse();
+    res.status(200).json({ success: true, data: { url } });
+
+    return {
+      ok: res.statusCode < 400,
+      status: res.statusCode,
+      headers: { get: () => null },
+      json: async () => res.body,
+    };
+  });
+  (global as any).fetch = fetchMock;
+  return fetchMock;
+}
+
+describe('API client', () => {
+  beforeEach(() => {
+    setPostRepository(new PostRepository(mockPosts));
+    responseCache.invalidate();
+  });
+
+  it('shares one request between identical in-flight GETs', async () => {
+    const fetchMock = mockFetch();
+
+    const [first, second] = await Promise.all([postsApi.getAll(), postsApi.getAll()]);
+    expect(fetchMock).toHaveBeenCalledTimes(1);
+    expect(second).toBe(first);
+
+    // Now cached
+    const hits = responseCache.stats.hits;
+    await postsApi.getAll();
+    expect(fetchMock).toHaveBeenCalledTimes(1);
+    expect(responseCache.stats.hits).toBe(hits + 1);
+  });
+
+  it('drops cached reads after a write', async () => {
+    const fetchMock = mockFetch();
+
+    await postsApi.getAll();
+    await postsApi.create({ title: 'New', content: 'Post' });
+    await postsApi.getAll();
+
+    expect(fetchMock.mock.calls.map(call => call[0])).toEqual(['/api/posts', '/api/posts', '/api/posts']);
+  });
+
+  it('reads listing pages by query', async () => {
+    const fetchMock = mockFetch();
+
+    await postsApi.getAll({ limit: 20, search: 'next js', cursor: undefined });
+    await postsApi.getAll({ limit: 20, search: 'next js' });
+
+    expect(fetchMock.mock.calls.map(call => call[0])).toEqual(['/api/posts?limit=20&search=next%20js']);
+  });
+});
+
+describe('POST /api/posts/batch', () => {
+  beforeEach(() => {
+    setPostRepository(new PostRepository(mockPosts));
+  });
+
+  it('returns the posts found and the ids that were not', () => {
+    const res = createResponse();
+    batchHandler(createRequest('POST', {}, { ids: ['2', 'nope', '1'] }), res);
+
+    expect(res.statusCode).toBe(200);
+    const { posts, missing } = (res.body as { data: PostBatch }).data;
+    expect(posts.map(post => post.id)).toEqual(['2', '1']);
+    expect(missing).toEqual(['nope']);
+  });
+
+  it('rejects malformed and oversized batches', () => {
+    const malformed = createResponse();
+    batchHandler(createRequest('POST', {}, { ids: [1, 2] }), malformed);
+    expect(malformed.statusCode).toBe(400);
+
+    const oversized = createResponse();
+    const ids = Array.from({ length: 101 }, (_, i) => String(i));
+    batchHandler(createRequest('POST', {}, { ids }), oversized);
+    expect(oversized.statusCode).toBe(400);
+
+    const wrongMethod = createResponse();
+    batchHandler(createRequest('GET', {}), wrongMethod);
+    expect(wrongMethod.statusCode).toBe(405);
+  });
+});
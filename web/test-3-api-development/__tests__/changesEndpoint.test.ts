@@ -0,0 +1,42 @@
+/**
+ * @jest-environment node
+ */
+import changesHandler from '@/pages/api/posts/changes';
+import { PostRepository, setPostRepository } from '@/server/postRepository';
+import { mockPosts } from '@/utils/mockData';
+import { createRequest, createResponse } from '@/benchmarks/harness';
+import { PostChangeSet } from '@/types';
+
+describe('GET /api/posts/changes', () => {
+  let repository: PostRepository;
+
+  const poll = (query: Record<string, string>, etag?: string) => {
+    const res = createResponse();
+    changesHandler(createRequest('GET', query, undefined, etag ? { 'if-none-match': etag } : {}), res);
+    return res;
+  };
+
+  beforeEach(() => {
+    repository = new PostRepository(mockPosts);
+    setPostRepository(repository);
+  });
+
+  it('gives each page of changes its own validator', () => {
+    const since = repository.version;
+    ['1', '2', '3'].forEach(id => repository.update(id, { title: `Edited ${id}` }));
+
+    const first = poll({ since: String(since), limit: '2' });
+    const page = (first.body as { data: PostChangeSet }).data;
+    expect(page.hasMore).toBe(true);
+    const rest = poll({ since: String(page.version), limit: '2' });
+    expect(rest.headers.etag).not.toBe(first.headers.etag);
+
+    // Unchanged pages revalidate; another range never matches
+    expect(poll({ since: String(since), limit: '2' }, first.headers.etag as string).statusCode).toBe(304);
+    expect(poll({ since: String(page.version), limit: '2' }, first.headers.etag as string).statusCode).toBe(200);
+
+    // A write to a post on the page moves it out of the range
+    repository.update('1', { title: 'Edited again' });
+    expect(poll({ since: String(since), limit: '2' }, first.headers.etag as string).statusCode).toBe(200);
+  });
+});
@@ -0,0 +1,135 @@
+/**
+ * @jest-environment node
+ */
+import { PostRepository } from '@/server/postRepository';
+import { DatasetGenerator, DatasetRecord, createZipf, createRandom } from '@/utils/dataset';
+import { checkCreatePost } from '@/utils/validation';
+import { loadDataset } from '@/benchmarks/harness';
+
+const options = { seed: 7, users: 500, posts: 2000 };
+
+async function collect(generator: DatasetGenerator): Promise<DatasetRecord[]> {
+  const records: DatasetRecord[] = [];
+  await generator.generate(record => {
+    records.push(record);
+  });
+  return records;
+}
+
+describe('DatasetGenerator', () => {
+  it('produces the same records for the same seed', async () => {
+    const first = await collect(new DatasetGenerator(options));
+    const second = await collect(new DatasetGenerator(options));
+    expect(second).toEqual(first);
+
+    const other = new DatasetGenerator({ ...options, seed: 8 });
+    expect(other.post(0)).not.toEqual(new DatasetGenerator(options).post(0));
+  });
+
+  it('rebuilds any post on its own', async () => {
+    const records = await collect(new DatasetGenerator(options));
+    const posts = records.map(record => (record.type === 'post' ? record.post : null)).filter(Boolean);
+    expect(new DatasetGenerator(options).post(1234)).toEqual(posts[1234]);
+  });
+
+  it('emits users, then each post followed by its comments', async () => {
+    const records = await collect(new DatasetGenerator(options));
+    expect(records.slice(0, 500).every(record => record.type === 'user')).toBe(true);
+
+    let postId = '';
+    records.slice(500).forEach(record => {
+      if (record.type === 'post') {
+        postId = record.post.id;
+      } else {
+        expect(record.type).toBe('comment');
+        expect(record.type === 'comment' && record.comment.postId).toBe(postId);
+      }
+    });
+  });
+
+  it('keeps likes, likers and author counts consistent', async () => {
+    const generator = new DatasetGenerator(options);
+    const postsByAuthor = new Map<string, number>();
+    const userCounts = new Map<string, number>();
+
+    await generator.generate(record => {
+      if (record.type === 'user') {
+        userCounts.set(record.user.id, record.user.postsCount);
+      } else if (record.type === 'post') {
+        const { post } = record;
+        expect(post.likedBy).toHaveLength(post.likes);
+        expect(new Set(post.likedBy).size).toBe(post.likes);
+        expect(post.author.id).toBe(post.authorId);
+        postsByAuthor.set(post.authorId, (postsByAuthor.get(post.authorId) || 0) + 1);
+      }
+    });
+
+    userCounts.forEach((count, id) => {
+      expect(postsByAuthor.get(id) || 0).toBe(count);
+    });
+  });
+
+  it('generates heavy-tailed likes and authorship with a mix of images', async () => {
+    const generator = new DatasetGenerator({ seed: 3, users: 2000, posts: 20000, comments: false });
+    const likes: number[] = [];
+    const byAuthor = new Map<string, number>();
+    let images = 0;
+
+    await generator.generate(record => {
+      if (record.type === 'post') {
+        likes.push(record.post.likes);
+        byAuthor.set(record.post.authorId, (byAuthor.get(record.post.authorId) || 0) + 1);
+        if (record.post.imageUrl) {
+          images++;
+        }
+      }
+    });
+
+    likes.sort((a, b) => a - b);
+    const median = likes[likes.length / 2];
+    expect(median).toBeLessThan(10);
+    expect(likes[likes.length - 1]).toBeGreaterThan(median * 50);
+
+    // The top 1% of authors write a large share of the posts
+    const counts = Array.from(byAuthor.values()).sort((a, b) => b - a);
+    const top = counts.slice(0, 20).reduce((sum, count) => sum + count, 0);
+    expect(top / 20000).toBeGreaterThan(0.3);
+
+    expect(images / 20000).toBeGreaterThan(0.3);
+    expect(images / 20000).toBeLessThan(0.4);
+  });
+
+  it('generates posts the API accepts', () => {
+    const generator = new DatasetGenerator(options);
+    for (let i = 0; i < options.posts; i++) {
+      const { title, content, imageUrl } = generator.post(i);
+      expect(checkCreatePost({ title, content, imageUrl })).toBeNull();
+    }
+  });
+
+  it('loads straight into a repository', async () => {
+    const repository = new PostRepository();
+    const stats = await loadDataset(repository, new DatasetGenerator({ ...options, comments: false }));
+    expect(stats).toMatchObject({ users: 500, posts: 2000, comments: 0 });
+    expect(repository.size).toBe(2000);
+    expect(repository.get('post-42')).toEqual(new DatasetGenerator(options).post(42));
+  });
+});
+
+describe('createZipf', () => {
+  it('stays in range and favours low indexes', () => {
+    [0.9, 1, 1.1].forEach(exponent => {
+      const pick = createZipf(100, exponent);
+      const random = createRandom(1);
+      const counts = new Array(100).fill(0);
+      for (let i = 0; i < 10000; i++) {
+        const index = pick(random);
+        expect(index).toBeGreaterThanOrEqual(0);
+        expect(index).toBeLessThan(100);
+        counts[index]++;
+      }
+      expect(counts[0]).toBeGreaterThan(counts[9]);
+      expect(counts[9]).toBeGreaterThan(counts[99]);
+    });
+  });
+});
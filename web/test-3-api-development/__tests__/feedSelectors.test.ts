@@ -0,0 +1,36 @@
+import { createFeedSelector, feedComparator, feedPredicate } from '@/utils/feedSelectors';
+import { mockPosts } from '@/utils/mockData';
+import { Post, PostFilters } from '@/types';
+
+const fullRecompute = (posts: Post[], filters: PostFilters) =>
+  posts.filter(feedPredicate(filters)).sort(feedComparator(filters));
+
+describe('createFeedSelector', () => {
+  const filters: PostFilters = { search: '', sortBy: 'popularity', sortOrder: 'desc' };
+
+  it('returns the same array for unchanged inputs', () => {
+    const selectFeed = createFeedSelector();
+    const first = selectFeed(mockPosts, filters);
+    expect(selectFeed(mockPosts, filters)).toBe(first);
+  });
+
+  it('patches the result when single posts change', () => {
+    const selectFeed = createFeedSelector();
+    selectFeed(mockPosts, filters);
+
+    const liked = mockPosts.map(post => (post.id === '4' ? { ...post, likes: 99 } : post));
+    expect(selectFeed(liked, filters)).toEqual(fullRecompute(liked, filters));
+
+    const created = [{ ...mockPosts[1], id: 'new', likes: 20 }, ...liked.filter(p => p.id !== '2')];
+    expect(selectFeed(created, filters)).toEqual(fullRecompute(created, filters));
+  });
+
+  it('narrows the previous result as the search grows', () => {
+    const selectFeed = createFeedSelector();
+    selectFeed(mockPosts, { ...filters, search: 're' });
+
+    const narrowed = { ...filters, search: 'react' };
+    expect(selectFeed(mockPosts, narrowed)).toEqual(fullRecompute(mockPosts, narrowed));
+    expect(selectFeed(mockPosts, narrowed).map(p => p.id)).toEqual(['3', '5', '2']);
+  });
+});
@@ -0,0 +1,64 @@
+/**
+ * @jest-environment node
+ */
+import { IMAGE_WIDTHS, buildSrcSet, imageVariant } from '@/utils/images';
+import { createImagePlaceholder } from '@/server/imagePlaceholder';
+
+const unsplash = 'https://images.unsplash.com/photo-1555066931-4365d14bab8c?w=400';
+
+function fakeFetch(body: Buffer, contentType = 'image/jpeg', ok = true) {
+  return jest.fn(async () => ({
+    ok,
+    headers: { get: (name: string) => (name === 'Content-Type' ? contentType : null) },
+    arrayBuffer: async () => body.buffer.slice(body.byteOffset, body.byteOffset + body.length),
+  }));
+}
+
+describe('image variants', () => {
+  it('builds a srcset over the width buckets for resizable hosts', () => {
+    const srcSet = buildSrcSet(unsplash) as string;
+    const candidates = srcSet.split(', ');
+
+    expect(candidates).toHaveLength(IMAGE_WIDTHS.length);
+    expect(candidates[0]).toMatch(/[?&]w=320&.* 320w$/);
+    expect(candidates[0]).toContain('auto=format');
+    // The original w=400 is replaced, not duplicated
+    expect(candidates[0].match(/[?&]w=/g)).toHaveLength(1);
+  });
+
+  it('leaves other hosts alone', () => {
+    const url = 'https://via.placeholder.com/600x400';
+    expect(buildSrcSet(url)).toBeUndefined();
+    expect(imageVariant(url, 320)).toBe(url);
+    expect(imageVariant('not a url', 320)).toBe('not a url');
+  });
+});
+
+describe('createImagePlaceholder', () => {
+  it('inlines a tiny thumbnail as a data URI', async () => {
+    const fetcher = fakeFetch(Buffer.from('tiny-jpeg'));
+    const placeholder = await createImagePlaceholder(`${unsplash}&a=1`, fetcher);
+
+    expect(placeholder).toBe(`data:image/jpeg;base64,${Buffer.from('tiny-jpeg').toString('base64')}`);
+    expect(fetcher).toHaveBeenCalledWith(expect.stringContaining('w=16'), expect.anything());
+
+    // Cached per image URL
+    await createImagePlaceholder(`${unsplash}&a=1`, fetcher);
+    expect(fetcher).toHaveBeenCalledTimes(1);
+  });
+
+  it('gives up on oversized, non-image and failed responses', async () => {
+    expect(await createImagePlaceholder(`${unsplash}&a=2`, fakeFetch(Buffer.alloc(10000)))).toBeUndefined();
+    expect(await createImagePlaceholder(`${unsplash}&a=3`, fakeFetch(Buffer.from('<html>'), 'text/html'))).toBeUndefined();
+    const failing = jest.fn(async () => {
+      throw new Error('network down');
+    });
+    expect(await createImagePlaceholder(`${unsplash}&a=4`, failing)).toBeUndefined();
+  });
+
+  it('never downloads images from hosts that cannot resize', async () => {
+    const fetcher = fakeFetch(Buffer.from('x'));
+    expect(await createImagePlaceholder('https://via.placeholder.com/600x400', fetcher)).toBeUndefined();
+    expect(fetcher).not.toHaveBeenCalled();
+  });
+});
@@ -0,0 +1,91 @@
+/**
+ * @jest-environment node
+ */
+import likeHandler from '@/pages/api/posts/[id]/like';
+import postHandler from '@/pages/api/posts/[id]';
+import { PostRepository, setPostRepository } from '@/server/postRepository';
+import { mockPosts } from '@/utils/mockData';
+import { createRequest, createResponse } from '@/benchmarks/harness';
+import { LikeState, Post } from '@/types';
+
+const nextTick = () => new Promise(resolve => setImmediate(resolve));
+
+describe('POST /api/posts/[id]/like', () => {
+  let repository: PostRepository;
+
+  beforeEach(() => {
+    repository = new PostRepository(mockPosts);
+    setPostRepository(repository);
+  });
+
+  it('toggles a like and keeps the counter in step', async () => {
+    const res = createResponse();
+    await likeHandler(createRequest('POST', { id: '2' }, { userId: 'u1' }), res);
+    expect(res.statusCode).toBe(200);
+    // Just the like state, however many users like the post
+    expect((res.body as { data: LikeState }).data).toEqual({ likes: 24, liked: true, version: repository.versionOf('2') });
+
+    await likeHandler(createRequest('POST', { id: '2' }, { userId: 'u1' }), createResponse());
+    expect(repository.get('2')?.likes).toBe(23);
+    expect(repository.get('2')?.likedBy).not.toContain('u1');
+  });
+
+  it('rebuilds likedBy only when the full post is read', () => {
+    const before = repository.get('2') as Post;
+    repository.setLike('2', 'u1', true);
+    repository.setLike('2', 'u2', true);
+    repository.setLike('2', 'u1', false);
+
+    // Handed-out posts never change; the next read sees every toggle
+    expect(before.likedBy).toEqual(mockPosts[1].likedBy);
+    const after = repository.get('2') as Post;
+    expect(after.likedBy).toEqual(mockPosts[1].likedBy.concat('u2'));
+    expect(after.likes).toBe(mockPosts[1].likes + 1);
+    expect(repository.get('2')).toBe(after);
+    expect(repository.likeCount('2')).toBe(after.likes);
+  });
+
+  it('never loses updates under thousands of parallel likes', async () => {
+    const users = Array.from({ length: 5000 }, (_, i) => `user-${i}`);
+
+    await Promise.all(
+      users.map(async (userId, i) => {
+        await new Promise(resolve => setTimeout(resolve, i % 7));
+        await likeHandler(createRequest('POST', { id: '4' }, { userId, liked: true }), createResponse());
+        // Repeating an explicit like is a no-op
+        await likeHandler(createRequest('POST', { id: '4' }, { userId, liked: true }), createResponse());
+      })
+    );
+
+    const post = repository.get('4') as Post;
+    expect(post.likes).toBe(mockPosts[3].likes + users.length);
+    expect(new Set(post.likedBy).size).toBe(mockPosts[3].likedBy.length + users.length);
+  });
+
+  it('rejects stale If-Match and converges with compare-and-swap retries', async () => {
+    let conflicts = 0;
+
+    const likeWithCas = async (userId: string) => {
+      for (;;) {
+        const read = createResponse();
+        postHandler(createRequest('GET', { id: '1' }), read);
+        await nextTick();
+
+        const write = createResponse();
+        await likeHandler(
+          createRequest('POST', { id: '1' }, { userId, liked: true }, { 'if-match': read.headers.etag as string }),
+          write
+        );
+        if (write.statusCode !== 412) {
+          return;
+        }
+        conflicts++;
+      }
+    };
+
+    await Promise.all(Array.from({ length: 200 }, (_, i) => likeWithCas(`cas-${i}`)));
+
+    expect(conflicts).toBeGreaterThan(0);
+    expect(repository.get('1')?.likes).toBe(mockPosts[0].likes + 200);
+  });
+});
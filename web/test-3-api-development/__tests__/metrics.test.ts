@@ -0,0 +1,79 @@
+/**
+ * @jest-environment node
+ */
+import type { NextApiRequest, NextApiResponse } from 'next';
+import metricsHandler from '@/pages/api/metrics';
+import postHandler from '@/pages/api/posts/[id]';
+import { ApiMetrics, LogHistogram, getApiMetrics, setApiMetrics, withMetrics } from '@/server/metrics';
+import { PostRepository, setPostRepository } from '@/server/postRepository';
+import { mockPosts } from '@/utils/mockData';
+import { createRequest, createResponse } from '@/benchmarks/harness';
+
+describe('LogHistogram', () => {
+  it('reads quantiles to within a bucket', () => {
+    const histogram = new LogHistogram();
+    for (let value = 1; value <= 10000; value++) {
+      histogram.record(value);
+    }
+
+    expect(histogram.count).toBe(10000);
+    [0.5, 0.9, 0.99].forEach(q => {
+      const exact = q * 10000;
+      expect(histogram.quantile(q)).toBeGreaterThanOrEqual(exact);
+      expect(histogram.quantile(q)).toBeLessThanOrEqual(exact * 1.04);
+    });
+  });
+
+  it('counts values at or below power-of-two bounds exactly', () => {
+    const histogram = new LogHistogram();
+    [10, 63, 64, 64.5, 100, 128, 5000].forEach(value => histogram.record(value));
+
+    expect(histogram.cumulative([64, 128, 4096, 8192])).toEqual([3, 6, 6, 7]);
+  });
+});
+
+describe('withMetrics', () => {
+  beforeEach(() => {
+    setApiMetrics(new ApiMetrics());
+    setPostRepository(new PostRepository(mockPosts));
+  });
+
+  it('records latency, sizes and status per route and method', async () => {
+    const handler = withMetrics('/api/echo', async (req: NextApiRequest, res: NextApiResponse) => {
+      await new Promise(resolve => setTimeout(resolve, 5));
+      res.statusCode = 201;
+      res.end('héllo');
+    });
+
+    await handler(createRequest('POST', {}, 'hi', { 'content-length': '2' }), createResponse());
+    await new Promise(resolve => setTimeout(resolve, 0));
+
+    const [series] = getApiMetrics().routes;
+    expect(series).toMatchObject({ route: '/api/echo', method: 'POST' });
+    expect(series.latency.count).toBe(1);
+    expect(series.latency.sum).toBeGreaterThanOrEqual(4000);
+    expect(series.requestBytes.sum).toBe(2);
+    expect(series.responseBytes.sum).toBe(6);
+    expect(series.statuses.get(201)).toBe(1);
+  });
+
+  it('exposes instrumented routes in Prometheus text format', () => {
+    postHandler(createRequest('GET', { id: '1' }), createResponse());
+    postHandler(createRequest('GET', { id: 'missing' }), createResponse());
+    postHandler(createRequest('BREW', { id: '1' }), createResponse());
+
+    const res = createResponse();
+    metricsHandler(createRequest('GET'), res);
+    const text = res.body as string;
+
+    expect(res.headers['content-type']).toContain('text/plain; version=0.0.4');
+    expect(text).toContain('# TYPE api_request_duration_seconds histogram');
+    expect(text).toContain('api_request_duration_seconds_count{route="/api/posts/[id]",method="GET"} 2');
+    expect(text).toContain('api_request_duration_seconds_bucket{route="/api/posts/[id]",method="GET",le="+Inf"} 2');
+    expect(text).toContain('api_request_latency_seconds{route="/api/posts/[id]",method="GET",quantile="0.99"}');
+    expect(text).toContain('api_responses_total{route="/api/posts/[id]",method="GET",status="200"} 1');
+    expect(text).toContain('api_responses_total{route="/api/posts/[id]",method="GET",status="404"} 1');
+    // Unknown methods are folded into one series
+    expect(text).toContain('api_responses_total{route="/api/posts/[id]",method="OTHER",status="405"} 1');
+  });
+});
@@ -0,0 +1,230 @@
+/**
+ * @jest-environment node
+ */
+import fs from 'fs';
+import os from 'os';
+import path from 'path';
+import mutationsHandler from '@/pages/api/posts/mutations';
+import { PostRepository, setPostRepository } from '@/server/postRepository';
+import { IdempotencyStore, setIdempotencyStore } from '@/server/idempotency';
+import { attachPersistence } from '@/server/persistence';
+import { Outbox, OutboxPersistence, QueuedMutation } from '@/utils/outbox';
+import { mockPosts } from '@/utils/mockData';
+import { createRequest, createResponse } from '@/benchmarks/harness';
+import { MutationBatch, MutationResult, PostMutation } from '@/types';
+
+// Sends batches straight to the real handler
+async function sendToHandler(mutations: PostMutation[]): Promise<MutationResult[]> {
+  const res = createResponse();
+  await mutationsHandler(createRequest('POST', {}, { mutations }), res);
+  if (res.statusCode !== 200) {
+    throw new Error(`status ${res.statusCode}`);
+  }
+  return ((res.body as { data: MutationBatch }).data).results;
+}
+
+function memoryPersistence() {
+  const rows = new Map<string, QueuedMutation>();
+  const persistence: OutboxPersistence = {
+    load: async () => Array.from(rows.values()),
+    save: async mutation => {
+      rows.set(mutation.key, mutation);
+    },
+    remove: async keys => {
+      keys.forEach(key => rows.delete(key));
+    },
+  };
+  return { rows, persistence };
+}
+
+describe('Outbox', () => {
+  let repository: PostRepository;
+
+  beforeEach(() => {
+    repository = new PostRepository(mockPosts);
+    setPostRepository(repository);
+  });
+
+  it('squashes writes that wait in the queue', () => {
+    const outbox = new Outbox({ send: jest.fn() });
+
+    outbox.enqueue({ type: 'like', postId: '2', userId: 'u1', liked: true });
+    outbox.enqueue({ type: 'like', postId: '2', userId: 'u1', liked: false });
+    expect(outbox.size).toBe(0);
+
+    outbox.enqueue({ type: 'create', postId: 'new', data: { title: 'Draft', content: 'v1' } });
+    outbox.enqueue({ type: 'update', postId: 'new', data: { content: 'v2' } });
+    expect(outbox.pending).toEqual([
+      expect.objectContaining({ type: 'create', data: { title: 'Draft', content: 'v2' } }),
+    ]);
+
+    outbox.enqueue({ type: 'like', postId: 'new', userId: 'u1', liked: true });
+    outbox.enqueue({ type: 'delete', postId: 'new' });
+    expect(outbox.size).toBe(0);
+
+    outbox.enqueue({ type: 'update', postId: '1', data: { title: 'A' } });
+    outbox.enqueue({ type: 'delete', postId: '1' });
+    expect(outbox.pending).toEqual([expect.objectContaining({ type: 'delete', postId: '1' })]);
+  });
+
+  it('drains the whole queue in one request and reports each result', async () => {
+    const send = jest.fn(sendToHandler);
+    const outbox = new Outbox({ send });
+    const results: MutationResult[] = [];
+    outbox.onResult(result => results.push(result));
+    const likes = repository.get('2')!.likes;
+
+    outbox.enqueue({ type: 'create', postId: 'offline-1', data: { title: 'Hello', content: 'From the train' } });
+    outbox.enqueue({ type: 'like', postId: '2', userId: 'u9', liked: true });
+    outbox.enqueue({ type: 'update', postId: '1', data: { title: 'Edited offline' } });
+    outbox.enqueue({ type: 'delete', postId: 'missing' });
+    await outbox.drain();
+
+    expect(send).toHaveBeenCalledTimes(1);
+    expect(outbox.size).toBe(0);
+    expect(results.map(result => result.status)).toEqual([201, 200, 200, 404]);
+    expect(repository.get('offline-1')!.title).toBe('Hello');
+    expect(repository.get('2')!.likes).toBe(likes + 1);
+    expect(repository.get('1')!.title).toBe('Edited offline');
+  });
+
+  it('keeps the queue through failures and replays it safely', async () => {
+    let online = false;
+    let lostResponses = 1;
+    const send = jest.fn(async (mutations: PostMutation[]) => {
+      if (!online) {
+        throw new Error('offline');
+      }
+      const results = await sendToHandler(mutations);
+      // Applied on the server, but the response never arrives
+      if (lostResponses-- > 0) {
+        throw new Error('connection reset');
+      }
+      return results;
+    });
+    const outbox = new Outbox({ send });
+    const likes = repository.get('3')!.likes;
+
+    outbox.enqueue({ type: 'like', postId: '3', userId: 'u7', liked: true });
+    await outbox.drain();
+    expect(outbox.size).toBe(1);
+
+    online = true;
+    await outbox.drain();
+    expect(outbox.size).toBe(1);
+
+    const results: MutationResult[] = [];
+    outbox.onResult(result => results.push(result));
+    await outbox.drain();
+
+    expect(outbox.size).toBe(0);
+    expect(results[0]).toEqual(expect.objectContaining({ status: 200, replayed: true }));
+    expect(repository.get('3')!.likes).toBe(likes + 1);
+  });
+
+  it('restores the persisted queue in order', async () => {
+    const { rows, persistence } = memoryPersistence();
+    let now = 1000;
+    const first = new Outbox({ send: jest.fn(), persistence, now: () => now++ });
+    first.enqueue({ type: 'update', postId: '1', data: { title: 'One' } });
+    first.enqueue({ type: 'like', postId: '2', userId: 'u1', liked: true });
+    first.enqueue({ type: 'like', postId: '3', userId: 'u1', liked: true });
+    first.enqueue({ type: 'like', postId: '3', userId: 'u1', liked: false });
+    await first.ready;
+    await Promise.resolve();
+    expect(rows.size).toBe(2);
+
+    const second = new Outbox({ send: jest.fn(), persistence });
+    await second.ready;
+    expect(second.pending).toEqual(first.pending);
+  });
+});
+
+describe('Outbox forwarding', () => {
+  it('persists a follower write before forwarding it, so a new leader still sends it', async () => {
+    const { rows, persistence } = memoryPersistence();
+    const forwarded: QueuedMutation[] = [];
+    const follower = new Outbox({ send: jest.fn(), persistence });
+    await follower.ready;
+    follower.forwardTo(mutation => forwarded.push(mutation));
+
+    follower.enqueue({ type: 'like', postId: '2', userId: 'u1', liked: true });
+    expect(forwarded).toHaveLength(0);
+    await new Promise(resolve => setTimeout(resolve, 0));
+
+    expect(forwarded).toHaveLength(1);
+    expect(rows.get(forwarded[0].key)).toEqual(forwarded[0]);
+    expect(follower.size).toBe(0);
+
+    // The leader that should have received it closed; the next one reloads
+    const leader = new Outbox({ send: jest.fn(), persistence });
+    await leader.ready;
+    expect(leader.pending).toEqual([expect.objectContaining({ key: forwarded[0].key, postId: '2' })]);
+
+    // A forward that does arrive is not queued twice
+    leader.adopt(forwarded[0]);
+    expect(leader.size).toBe(1);
+  });
+});
+
+describe('IdempotencyStore', () => {
+  it('forgets keys past their ttl or the entry bound', () => {
+    let now = 0;
+    const store = new IdempotencyStore<number>({ maxEntries: 2, ttl: 100, now: () => now });
+    store.set('a', 1);
+    store.set('b', 2);
+    store.set('c', 3);
+    expect(store.get('a')).toBeUndefined();
+    expect(store.get('b')).toBe(2);
+
+    now = 101;
+    expect(store.get('c')).toBeUndefined();
+  });
+});
+
+describe('idempotency across a restart', () => {
+  let dir: string;
+
+  beforeEach(() => {
+    dir = fs.mkdtempSync(path.join(os.tmpdir(), 'posts-keys-'));
+  });
+
+  afterEach(() => {
+    fs.rmSync(dir, { recursive: true, force: true });
+  });
+
+  // A server process: a repository and key store restored from `dir`
+  const start = () => {
+    const repository = new PostRepository();
+    const keys = new IdempotencyStore<unknown>();
+    attachPersistence(repository, dir, keys);
+    setPostRepository(repository);
+    setIdempotencyStore(keys);
+    return repository;
+  };
+
+  it('answers a replayed create with the stored result, not a conflict', async () => {
+    const create: PostMutation = {
+      key: 'create-1',
+      type: 'create',
+      postId: 'offline-1',
+      data: { title: 'Written offline', content: 'Synced just before the restart' },
+    };
+    const like: PostMutation = { key: 'like-1', type: 'like', postId: 'offline-1', userId: 'u1', liked: true };
+
+    start();
+    const [created, liked] = await sendToHandler([create, like]);
+    expect(created.status).toBe(201);
+    expect(liked.status).toBe(200);
+
+    // The response was lost and the server restarted; the outbox replays
+    const restarted = start();
+    expect(restarted.get('offline-1')!.likes).toBe(1);
+
+    const replayed = await sendToHandler([create, like]);
+    expect(replayed[0]).toEqual(expect.objectContaining({ status: 201, replayed: true }));
+    expect(replayed[0].post!.title).toBe('Written offline');
+    expect(replayed[1]).toEqual(expect.objectContaining({ status: 200, replayed: true }));
+    expect(restarted.get('offline-1')!.likes).toBe(1);
+  });
+});
@@ -0,0 +1,259 @@
+import { PostEventBuffer, PostsResync, connectPostEvents } from '@/store/postEvents';
+import { orderEvents, usePostsStore } from '@/store/posts';
+import { mockPosts } from '@/utils/mockData';
+import { postsApi } from '@/utils/api';
+import { RealtimeConnection } from '@/utils/websocket';
+import { ApiResponse, PostChangeSet } from '@/types';
+import { WebSocketMessage, WebSocketMessageType } from '@/types/websocket';
+
+// The store starts empty; seed it as a loaded feed would
+usePostsStore.getState().receivePosts(mockPosts);
+const initialState = usePostsStore.getState();
+
+let seq = 0;
+function event(type: WebSocketMessageType, payload: unknown, userId = 'u1', run = 'run'): WebSocketMessage {
+  seq++;
+  return { type, payload, userId, seq, timestamp: 1000 + seq, messageId: `${run}-${seq}` };
+}
+
+const like = (postId: string, likes: number, userId: string, liked = true) =>
+  event('POST_LIKED', { postId, likes, liked }, userId);
+
+describe('post event ingestion', () => {
+  let frames: (() => void)[];
+  let buffer: PostEventBuffer;
+
+  const nextFrame = () => frames.splice(0).forEach(flush => flush());
+
+  beforeEach(() => {
+    usePostsStore.setState(initialState, true);
+    frames = [];
+    buffer = new PostEventBuffer(undefined, flush => frames.push(flush));
+  });
+
+  it('applies a burst of likes with one store update per frame', () => {
+    const hot = mockPosts[0];
+    const updates = jest.fn();
+    const unsubscribe = usePostsStore.subscribe(updates);
+
+    for (let i = 1; i <= 500; i++) {
+      buffer.push(like(hot.id, hot.likes + i, `liker-${i}`));
+    }
+    expect(frames).toHaveLength(1);
+    expect(updates).not.toHaveBeenCalled();
+
+    nextFrame();
+    unsubscribe();
+
+    expect(updates).toHaveBeenCalledTimes(1);
+    const record = usePostsStore.getState().byId[hot.id];
+    expect(record.likes).toBe(hot.likes + 500);
+    expect(record.likedBy).toHaveLength(hot.likedBy.length + 500);
+    // Other posts keep their identity
+    expect(usePostsStore.getState().byId[mockPosts[1].id]).toBe(initialState.byId[mockPosts[1].id]);
+  });
+
+  it('orders a batch by sequence before collapsing it', () => {
+    const post = mockPosts[1];
+    const first = like(post.id, 10, 'a');
+    const second = like(post.id, 11, 'b');
+    const unlike = like(post.id, 10, 'a', false);
+
+    [unlike, first, second, first].forEach(message => buffer.push(message));
+    nextFrame();
+
+    const record = usePostsStore.getState().byId[post.id];
+    expect(record.likes).toBe(10);
+    expect(record.likedBy).toContain('b');
+    expect(record.likedBy).not.toContain('a');
+  });
+
+  it('orders events from different server runs by timestamp', () => {
+    const late = { ...event('POST_DELETED', { postId: '1' }), messageId: 'old-900', seq: 900, timestamp: 1 };
+    const early = { ...event('POST_DELETED', { postId: '2' }), messageId: 'new-1', seq: 1, timestamp: 2 };
+    expect(orderEvents([early, late])).toEqual([late, early]);
+  });
+
+  it('lets the last event for a post win across creates, updates and deletes', () => {
+    const created = { ...mockPosts[0], id: 'fresh', createdAt: '2100-01-01T00:00:00Z' };
+    const doomed = mockPosts[2];
+
+    buffer.push(event('POST_CREATED', { post: created }));
+    buffer.push(like('fresh', 1, 'u2'));
+    buffer.push(event('POST_UPDATED', { post: { ...doomed, title: 'Edited' } }));
+    buffer.push(event('POST_DELETED', { postId: doomed.id }));
+    buffer.push(like(doomed.id, 99, 'u2'));
+    buffer.push(event('USER_TYPING', { postId: doomed.id }));
+    expect(buffer.pending).toBe(5);
+    nextFrame();
+
+    const state = usePostsStore.getState();
+    expect(state.orderedIds[0]).toBe('fresh');
+    expect(state.byId.fresh.likes).toBe(1);
+    expect(state.byId.fresh.likedBy).toContain('u2');
+    expect(state.byId[doomed.id]).toBeUndefined();
+    expect(state.orderedIds).not.toContain(doomed.id);
+  });
+
+  it('skips the store update when a batch changes nothing', () => {
+    const post = mockPosts[0];
+    const updates = jest.fn();
+    const unsubscribe = usePostsStore.subscribe(updates);
+
+    buffer.push(like(post.id, post.likes, post.likedBy[0] || 'nobody', post.likedBy.length > 0));
+    buffer.push(like('unknown', 5, 'u1'));
+    nextFrame();
+    unsubscribe();
+
+    expect(updates).not.toHaveBeenCalled();
+  });
+});
+
+describe('post event resync', () => {
+  // The parts of a RealtimeConnection connectPostEvents uses
+  class FakeConnection {
+    state = 'connecting';
+    feed: ((message: WebSocketMessage) => void)[] = [];
+    all: ((message: WebSocketMessage) => void)[] = [];
+    states: ((state: string) => void)[] = [];
+
+    subscribe(topic: string, listener: (message: WebSocketMessage) => void) {
+      this.feed.push(listener);
+      return () => undefined;
+    }
+    onMessage(listener: (message: WebSocketMessage) => void) {
+      this.all.push(listener);
+      return () => undefined;
+    }
+    onStateChange(listener: (state: string) => void) {
+      this.states.push(listener);
+      return () => undefined;
+    }
+    receive(message: WebSocketMessage) {
+      this.all.forEach(listener => listener(message));
+      this.feed.forEach(listener => listener(message));
+    }
+    setState(state: string) {
+      this.state = state;
+      this.states.forEach(listener => listener(state));
+    }
+  }
+
+  const changeSet = (changes: Partial<PostChangeSet>): ApiResponse<PostChangeSet> => ({
+    success: true,
+    data: { epoch: 'e1', version: 0, created: [], updated: [], deleted: [], hasMore: false, reset: false, ...changes },
+  });
+
+  let connection: FakeConnection;
+  let buffer: PostEventBuffer;
+  let fetchChanges: jest.Mock;
+  let refetch: jest.Mock;
+  let resync: PostsResync;
+  let stop: () => void;
+
+  const settle = () => new Promise(resolve => setTimeout(resolve, 0));
+
+  beforeEach(() => {
+    usePostsStore.setState(initialState, true);
+    connection = new FakeConnection();
+    buffer = new PostEventBuffer(undefined, () => undefined);
+    fetchChanges = jest.fn();
+    refetch = jest.fn();
+    resync = new PostsResync(buffer, fetchChanges, refetch);
+    stop = connectPostEvents(connection as unknown as RealtimeConnection, buffer, resync);
+  });
+
+  afterEach(() => {
+    stop();
+  });
+
+  it('takes a baseline on first connect, then fetches what a reconnect missed', async () => {
+    fetchChanges.mockResolvedValueOnce(changeSet({ version: 40, reset: true }));
+    connection.setState('connected');
+    await settle();
+    expect(fetchChanges).toHaveBeenLastCalledWith(0, 'none');
+    expect(resync.position).toEqual({ epoch: 'e1', version: 40 });
+    expect(refetch).not.toHaveBeenCalled();
+
+    // A live event moves the cursor on
+    connection.receive(event('POST_DELETED', { postId: mockPosts[3].id, epoch: 'e1', version: 41 }));
+    buffer.flush();
+
+    const edited = { ...mockPosts[1], title: 'Edited while away' };
+    fetchChanges.mockResolvedValueOnce(changeSet({ version: 44, updated: [edited], deleted: [mockPosts[2].id] }));
+    connection.setState('reconnecting');
+    connection.setState('connected');
+    await settle();
+    buffer.flush();
+
+    expect(fetchChanges).toHaveBeenLastCalledWith(41, 'e1');
+    expect(resync.position).toEqual({ epoch: 'e1', version: 44 });
+    const state = usePostsStore.getState();
+    expect(state.byId[mockPosts[1].id].title).toBe('Edited while away');
+    expect(state.byId[mockPosts[2].id]).toBeUndefined();
+    expect(state.byId[mockPosts[3].id]).toBeUndefined();
+  });
+
+  it('catches up from the server-rendered version on first connect', async () => {
+    resync.seed({ epoch: 'e1', version: 20 });
+    const created = { ...mockPosts[0], id: 'before-connect', createdAt: '2100-01-01T00:00:00Z' };
+    fetchChanges.mockResolvedValueOnce(changeSet({ version: 21, created: [created] }));
+    connection.setState('connected');
+    await settle();
+    buffer.flush();
+
+    expect(fetchChanges).toHaveBeenLastCalledWith(20, 'e1');
+    expect(refetch).not.toHaveBeenCalled();
+    expect(usePostsStore.getState().orderedIds[0]).toBe('before-connect');
+  });
+
+  it('re-syncs when the gateway reports dropped events', async () => {
+    connection.receive(event('POST_LIKED', { postId: mockPosts[0].id, likes: 7, liked: true, epoch: 'e1', version: 10 }));
+    buffer.flush();
+
+    const created = { ...mockPosts[0], id: 'missed', createdAt: '2100-01-01T00:00:00Z' };
+    fetchChanges
+      .mockResolvedValueOnce(changeSet({ version: 12, created: [created], hasMore: true }))
+      .mockResolvedValueOnce(changeSet({ version: 13, deleted: [mockPosts[1].id] }));
+    connection.receive(event('RESYNC', {}));
+    await settle();
+    buffer.flush();
+
+    expect(fetchChanges.mock.calls).toEqual([[10, 'e1'], [12, 'e1']]);
+    const state = usePostsStore.getState();
+    expect(state.orderedIds[0]).toBe('missed');
+    expect(state.byId[mockPosts[1].id]).toBeUndefined();
+  });
+
+  it('refetches the feed when the cursor is too old for delta sync', async () => {
+    connection.receive(event('POST_DELETED', { postId: 'gone', epoch: 'e1', version: 5 }));
+    fetchChanges.mockResolvedValueOnce(changeSet({ epoch: 'e2', version: 3, reset: true }));
+    connection.setState('connected');
+    await settle();
+
+    expect(refetch).toHaveBeenCalledTimes(1);
+    expect(resync.position).toEqual({ epoch: 'e2', version: 3 });
+  });
+
+  it('reloads the feed on reset, dropping posts the server no longer has', async () => {
+    stop();
+    resync = new PostsResync(buffer, fetchChanges);
+    stop = connectPostEvents(connection as unknown as RealtimeConnection, buffer, resync);
+    const survivor = { ...mockPosts[0], title: 'Still here' };
+    const getAll = jest.spyOn(postsApi, 'getAll').mockResolvedValueOnce({
+      success: true,
+      data: { data: [survivor], total: 1, limit: 20, hasMore: false, nextCursor: null },
+    });
+
+    connection.receive(event('POST_LIKED', { postId: mockPosts[1].id, likes: 3, liked: true, epoch: 'e1', version: 9 }));
+    fetchChanges.mockResolvedValueOnce(changeSet({ epoch: 'e2', version: 1, reset: true }));
+    connection.setState('connected');
+    await settle();
+
+    expect(getAll).toHaveBeenCalledTimes(1);
+    const state = usePostsStore.getState();
+    expect(state.orderedIds).toEqual([survivor.id]);
+    expect(state.byId[survivor.id].title).toBe('Still here');
+    getAll.mockRestore();
+  });
+});
@@ -0,0 +1,140 @@
+/**
+ * @jest-environment node
+ */
+import { PostKey, PostRepository } from '@/server/postRepository';
+import { SearchIndex, tokenize } from '@/server/searchIndex';
+import { mockPosts } from '@/utils/mockData';
+
+describe('PostRepository', () => {
+  let repository: PostRepository;
+
+  beforeEach(() => {
+    repository = new PostRepository(mockPosts);
+  });
+
+  it('looks posts up by id', () => {
+    expect(repository.size).toBe(mockPosts.length);
+    expect(repository.get('3')).toBe(mockPosts[2]);
+    expect(repository.get('missing')).toBeUndefined();
+  });
+
+  it('lists posts by date in both directions', () => {
+    const desc = repository.list({ sortBy: 'date', sortOrder: 'desc' }).map(p => p.id);
+    const asc = repository.list({ sortBy: 'date', sortOrder: 'asc' }).map(p => p.id);
+
+    expect(desc).toEqual(['1', '2', '3', '4', '5']);
+    expect(asc).toEqual(['5', '4', '3', '2', '1']);
+  });
+
+  it('re-sorts the popularity index when likes change', () => {
+    repository.update('4', { likes: 100 });
+
+    const ids = repository.list({ sortBy: 'popularity', sortOrder: 'desc' }).map(p => p.id);
+    expect(ids).toEqual(['4', '3', '5', '2', '1']);
+  });
+
+  it('keeps per-author listings in sync with inserts and removals', () => {
+    repository.insert({
+      ...mockPosts[0],
+      id: 'new',
+      createdAt: '2024-02-01T00:00:00Z',
+    });
+    repository.remove('5');
+
+    expect(repository.list({ authorId: '1' }).map(p => p.id)).toEqual(['new', '1']);
+  });
+
+  it('stays ordered across many block splits', () => {
+    const large = new PostRepository();
+    for (let i = 0; i < 5000; i++) {
+      // Insert out of order so every block gets spliced into
+      const n = (i * 7919) % 5000;
+      large.insert({
+        ...mockPosts[0],
+        id: `p${n}`,
+        likes: n % 97,
+        createdAt: new Date(Date.UTC(2024, 0, 1) + n * 1000).toISOString(),
+      });
+    }
+    for (let n = 0; n < 5000; n += 3) {
+      large.remove(`p${n}`);
+    }
+
+    const times = large.list({ sortOrder: 'asc' }).map(p => Date.parse(p.createdAt));
+    expect(times.length).toBe(large.size);
+    expect(times.every((t, i) => i === 0 || times[i - 1] < t)).toBe(true);
+  });
+
+  it('pages through a listing with keyset cursors', () => {
+    const seen: string[] = [];
+    let after: PostKey | undefined;
+
+    for (;;) {
+      const { posts, hasMore } = repository.page({ sortBy: 'popularity', limit: 2, after });
+      posts.forEach(post => seen.push(post.id));
+      if (!hasMore) break;
+      after = repository.keyOf(posts[posts.length - 1]);
+      // Moving a post ahead of the cursor must not shift later pages
+      repository.update('1', { likes: 1000 });
+    }
+
+    expect(seen).toEqual(['3', '5', '2', '4']);
+  });
+});
+
+describe('SearchIndex', () => {
+  it('matches every token, with the last one as a prefix', () => {
+    const index = new SearchIndex();
+    mockPosts.forEach(post => index.add(post.id, `${post.title} ${post.content} ${post.author.name}`));
+
+    expect(Array.from(index.search('react') || []).sort()).toEqual(['2', '3', '5']);
+    expect(Array.from(index.search('alice manag') || [])).toEqual(['5']);
+    expect(index.search('  ')).toBeNull();
+
+    index.remove('5');
+    expect(Array.from(index.search('zust') || [])).toEqual([]);
+  });
+
+  it('tokenizes letters and digits of any script', () => {
+    const index = new SearchIndex();
+    index.add('ja', '日本 の 投稿');
+    index.add('fr', 'Crème brûlée, déjà vu');
+
+    expect(tokenize('Crème brûlée!')).toEqual(['crème', 'brûlée']);
+    expect(Array.from(index.search('日本') || [])).toEqual(['ja']);
+    expect(Array.from(index.search('déj') || [])).toEqual(['fr']);
+    expect(index.search('!!!')).toBeNull();
+  });
+
+  it('returns an empty page for a search without tokens', () => {
+    const repository = new PostRepository(mockPosts);
+    expect(repository.page({ search: '!!!', limit: 20 })).toEqual({ posts: [], total: 0, hasMore: false });
+    expect(repository.page({ search: '日本', limit: 20 }).posts).toEqual([]);
+    expect(repository.page({ search: '', limit: 20 }).posts).toHaveLength(mockPosts.length);
+  });
+});
+
+describe('PostRepository change tracking', () => {
+  it('reports created, updated and deleted posts since a version', () => {
+    const repository = new PostRepository(mockPosts);
+    const since = repository.version;
+
+    repository.update('1', { title: 'Edited' });
+    repository.insert({ ...mockPosts[1], id: 'fresh' });
+    repository.remove('2');
+    repository.insert({ ...mockPosts[1], id: 'short-lived' });
+    repository.remove('short-lived');
+
+    const changes = repository.changesSince(since, 100);
+    expect(changes.created.map(p => p.id)).toEqual(['fresh']);
+    expect(changes.updated.map(p => p.id)).toEqual(['1']);
+    expect(changes.deleted).toEqual(['2']);
+    expect(changes.version).toBe(repository.version);
+    expect(repository.changesSince(repository.version, 100).created).toEqual([]);
+  });
+
+  it('asks clients from the future to resync', () => {
+    const repository = new PostRepository(mockPosts);
+    expect(repository.changesSince(repository.version + 10, 100).reset).toBe(true);
+  });
+});
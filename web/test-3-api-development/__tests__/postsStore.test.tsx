@@ -0,0 +1,184 @@
+import { act, render, screen } from '@testing-library/react';
+import { ChakraProvider } from '@chakra-ui/react';
+import PostsList from '@/components/PostsList';
+import { PostsStoreProvider, usePosts, usePostsStore } from '@/store/posts';
+import { ApiError, postsApi } from '@/utils/api';
+import { mockPosts } from '@/utils/mockData';
+import { Post } from '@/types';
+
+// Render-count harness: PostCard is replaced by a memoized stub that counts
+// how often each post's card renders
+const mockRenderCounts: Record<string, number> = {};
+
+jest.mock('@/components/PostCard', () => {
+  const React = jest.requireActual('react');
+  return {
+    __esModule: true,
+    default: React.memo(({ post }: { post: Post }) => {
+      mockRenderCounts[post.id] = (mockRenderCounts[post.id] || 0) + 1;
+      return React.createElement('div', null, `${post.title} (${post.likes})`);
+    }),
+  };
+});
+
+// The store starts empty; seed it as a loaded feed would
+usePostsStore.getState().receivePosts(mockPosts);
+const initialState = usePostsStore.getState();
+
+const Feed = () => {
+  const posts = usePosts();
+  return <PostsList posts={posts} />;
+};
+
+const renderFeed = () => {
+  return render(
+    <ChakraProvider>
+      <Feed />
+    </ChakraProvider>
+  );
+};
+
+describe('posts store', () => {
+  beforeEach(() => {
+    usePostsStore.setState(initialState, true);
+    Object.keys(mockRenderCounts).forEach(id => delete mockRenderCounts[id]);
+  });
+
+  it('stores posts normalized by id with shared authors', () => {
+    const { byId, orderedIds, authorsById } = usePostsStore.getState();
+
+    expect(orderedIds).toHaveLength(mockPosts.length);
+    expect(byId[mockPosts[0].id]).not.toHaveProperty('author');
+    expect(authorsById[mockPosts[0].authorId]).toBe(mockPosts[0].author);
+
+    // Newest first
+    const times = orderedIds.map(id => byId[id].createdAt);
+    expect(times).toEqual(times.slice().sort().reverse());
+  });
+
+  it('re-renders exactly one card when one post is liked', () => {
+    renderFeed();
+    const { byId, orderedIds } = usePostsStore.getState();
+    const target = byId[orderedIds[0]];
+    const before = { ...mockRenderCounts };
+    expect(Object.keys(before).length).toBeGreaterThan(1);
+
+    act(() => {
+      usePostsStore.getState().likePost(target.id, 'someone-new');
+    });
+
+    expect(screen.getByText(`${target.title} (${target.likes + 1})`)).toBeInTheDocument();
+    Object.keys(before).forEach(id => {
+      expect(mockRenderCounts[id]).toBe(id === target.id ? before[id] + 1 : before[id]);
+    });
+  });
+
+  it('re-renders nothing when received posts are unchanged copies', () => {
+    renderFeed();
+    const before = { ...mockRenderCounts };
+    const state = usePostsStore.getState();
+
+    act(() => {
+      state.receivePosts(mockPosts.map(post => ({ ...post, author: { ...post.author } })));
+    });
+
+    expect(usePostsStore.getState().byId).toBe(state.byId);
+    expect(usePostsStore.getState().authorsById).toBe(state.authorsById);
+    expect(mockRenderCounts).toEqual(before);
+  });
+
+  it('keeps other records when a post is updated or deleted', () => {
+    const { byId } = usePostsStore.getState();
+    const [first, second] = usePostsStore.getState().orderedIds;
+
+    act(() => {
+      usePostsStore.getState().updatePost(first, { title: 'Edited' });
+    });
+    expect(usePostsStore.getState().byId[first].title).toBe('Edited');
+    expect(usePostsStore.getState().byId[second]).toBe(byId[second]);
+
+    act(() => {
+      usePostsStore.getState().deletePost(first);
+    });
+    expect(usePostsStore.getState().orderedIds).not.toContain(first);
+    expect(usePostsStore.getState().byId[second]).toBe(byId[second]);
+  });
+
+  it('replaces the posts with the first page from the API', async () => {
+    const edited = { ...mockPosts[0], title: 'Edited on the server' };
+    const created = { ...mockPosts[1], id: 'created', createdAt: '2100-01-01T00:00:00Z' };
+    const getAll = jest.spyOn(postsApi, 'getAll').mockResolvedValueOnce({
+      success: true,
+      data: { data: [created, edited], total: 2, limit: 20, hasMore: false, nextCursor: null },
+    });
+
+    await usePostsStore.getState().fetchPosts();
+
+    expect(getAll).toHaveBeenCalledWith({ limit: 20 });
+    const state = usePostsStore.getState();
+    expect(state.orderedIds).toEqual(['created', mockPosts[0].id]);
+    expect(state.byId[mockPosts[0].id].title).toBe('Edited on the server');
+    expect(state.loading).toBe(false);
+    expect(state.fetchedAt).not.toBeNull();
+    getAll.mockRestore();
+  });
+
+  it('keeps the posts and reports the error when the fetch fails', async () => {
+    const getAll = jest.spyOn(postsApi, 'getAll').mockRejectedValueOnce(new ApiError(500, 'HTTP error! status: 500'));
+    const { byId } = usePostsStore.getState();
+
+    await usePostsStore.getState().fetchPosts();
+
+    const state = usePostsStore.getState();
+    expect(state.error).toBe('HTTP error! status: 500');
+    expect(state.loading).toBe(false);
+    expect(state.byId).toBe(byId);
+    getAll.mockRestore();
+  });
+
+  it('renders server-rendered posts on the first render and hydrates only once', () => {
+    const serverPosts = [{ ...mockPosts[1], title: 'From the server' }];
+    const Page = ({ initialPosts }: { initialPosts: Post[] }) => (
+      <PostsStoreProvider initialPosts={initialPosts} initialVersion={{ epoch: 'e1', version: 7 }}>
+        <Feed />
+      </PostsStoreProvider>
+    );
+
+    const { rerender, unmount } = render(
+      <ChakraProvider>
+        <Page initialPosts={serverPosts} />
+      </ChakraProvider>
+    );
+    expect(screen.getByText(/From the server/)).toBeInTheDocument();
+    expect(screen.queryByText(new RegExp(mockPosts[0].title))).not.toBeInTheDocument();
+    expect(usePostsStore.getState().fetchedAt).not.toBeNull();
+    // Where the realtime resync picks up
+    expect(usePostsStore.getState().serverVersion).toEqual({ epoch: 'e1', version: 7 });
+
+    // Re-rendering with the same props keeps client-side changes
+    act(() => {
+      usePostsStore.getState().updatePost(mockPosts[1].id, { title: 'Edited' });
+    });
+    rerender(
+      <ChakraProvider>
+        <Page initialPosts={serverPosts} />
+      </ChakraProvider>
+    );
+    expect(screen.getByText(/Edited/)).toBeInTheDocument();
+    unmount();
+
+    // Navigating back to the feed merges its posts into what the store has
+    const optimistic = { ...mockPosts[0], id: 'optimistic', title: 'Not yet synced', createdAt: '2100-01-01T00:00:00Z' };
+    act(() => {
+      usePostsStore.getState().receivePosts([optimistic]);
+    });
+    render(
+      <ChakraProvider>
+        <Page initialPosts={[{ ...mockPosts[2], title: 'Fresh from the server' }]} />
+      </ChakraProvider>
+    );
+    expect(screen.getByText(/Not yet synced/)).toBeInTheDocument();
+    expect(screen.getByText(/Fresh from the server/)).toBeInTheDocument();
+    expect(screen.getByText(/Edited/)).toBeInTheDocument();
+  });
+});
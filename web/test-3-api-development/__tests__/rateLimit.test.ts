@@ -0,0 +1,117 @@
+/**
+ * @jest-environment node
+ */
+import type { NextApiRequest, NextApiResponse } from 'next';
+import postHandler from '@/pages/api/posts/[id]';
+import { PostRepository, setPostRepository } from '@/server/postRepository';
+import { RateLimiter, TokenBuckets, setRateLimiter, withRateLimit } from '@/server/rateLimit';
+import { mockPosts } from '@/utils/mockData';
+import { createRequest, createResponse } from '@/benchmarks/harness';
+
+describe('TokenBuckets', () => {
+  it('allows a burst, then refills at the sustained rate', () => {
+    let now = 0;
+    const buckets = new TokenBuckets({ capacity: 3, refillPerSecond: 2 }, 100, () => now);
+
+    expect([buckets.take('a'), buckets.take('a'), buckets.take('a')]).toEqual([0, 0, 0]);
+    expect(buckets.take('a')).toBe(500);
+    // Other keys have their own budget
+    expect(buckets.take('b')).toBe(0);
+
+    now = 500;
+    expect(buckets.take('a')).toBe(0);
+    expect(buckets.take('a')).toBe(500);
+  });
+
+  it('forgets the least recently seen keys past the cap', () => {
+    const buckets = new TokenBuckets({ capacity: 1, refillPerSecond: 1 }, 2, () => 0);
+
+    buckets.take('a');
+    buckets.take('b');
+    buckets.take('a'); // 'a' is now the most recent
+    buckets.take('c');
+
+    expect(buckets.size).toBe(2);
+    // 'a' is still tracked (and empty); 'b' was evicted and starts over full
+    expect(buckets.take('a')).toBeGreaterThan(0);
+    expect(buckets.take('b')).toBe(0);
+  });
+});
+
+describe('withRateLimit', () => {
+  const fromClient = (method: string, query: Record<string, string> = {}, body?: unknown, ip = '203.0.113.7') =>
+    createRequest(method, query, body, { 'x-forwarded-for': ip });
+
+  beforeEach(() => {
+    setPostRepository(new PostRepository(mockPosts));
+    setRateLimiter(new RateLimiter({ write: { capacity: 2, refillPerSecond: 0.5 }, trustProxy: true, now: () => 0 }));
+  });
+
+  it('answers 429 with Retry-After once a client spends its write budget', async () => {
+    for (let i = 0; i < 2; i++) {
+      const res = createResponse();
+      await postHandler(fromClient('PUT', { id: '1' }, { title: `Edit ${i}` }), res);
+      expect(res.statusCode).toBe(200);
+    }
+
+    const limited = createResponse();
+    await postHandler(fromClient('PUT', { id: '1' }, { title: 'One too many' }), limited);
+    expect(limited.statusCode).toBe(429);
+    expect(limited.headers['retry-after']).toBe('2');
+
+    // Reads have a separate budget, and other clients are unaffected
+    const read = createResponse();
+    postHandler(fromClient('GET', { id: '1' }), read);
+    expect(read.statusCode).toBe(200);
+    const other = createResponse();
+    await postHandler(fromClient('PUT', { id: '1' }, { title: 'Fine' }, '198.51.100.2'), other);
+    expect(other.statusCode).toBe(200);
+  });
+
+  it('does not key budgets on the unauthenticated X-User-Id header', async () => {
+    const statuses: number[] = [];
+    for (let i = 0; i < 3; i++) {
+      const res = createResponse();
+      const req = createRequest('PUT', { id: '1' }, { title: `Edit ${i}` }, {
+        'x-forwarded-for': '203.0.113.7',
+        'x-user-id': `rotated-${i}`,
+      });
+      await postHandler(req, res);
+      statuses.push(res.statusCode);
+    }
+
+    expect(statuses).toEqual([200, 200, 429]);
+  });
+
+  it('sheds writes but not reads while writes are backed up', async () => {
+    setRateLimiter(new RateLimiter({ maxPendingWrites: 2 }));
+    let finishWrites: () => void = () => undefined;
+    const stalled = new Promise<void>(resolve => {
+      finishWrites = resolve;
+    });
+    const handler = withRateLimit((req: NextApiRequest, res: NextApiResponse) => {
+      if (req.method === 'GET') {
+        return res.status(200).json({ success: true });
+      }
+      return stalled.then(() => res.status(201).json({ success: true }));
+    });
+
+    handler(createRequest('POST'), createResponse());
+    handler(createRequest('POST'), createResponse());
+
+    const shed = createResponse();
+    handler(createRequest('POST'), shed);
+    expect(shed.statusCode).toBe(503);
+    expect(shed.headers['retry-after']).toBe('1');
+
+    const read = createResponse();
+    handler(createRequest('GET'), read);
+    expect(read.statusCode).toBe(200);
+
+    finishWrites();
+    await new Promise(resolve => setTimeout(resolve, 0));
+    const accepted = createResponse();
+    await handler(createRequest('POST'), accepted);
+    expect(accepted.statusCode).toBe(201);
+  });
+});
@@ -0,0 +1,187 @@
+/**
+ * @jest-environment node
+ */
+import { PostRepository } from '@/server/postRepository';
+import { FEED_TOPIC, RealtimeGateway, RealtimeSocket, postTopic } from '@/server/realtime';
+import { WebSocketMessage } from '@/types/websocket';
+import { seedPosts } from '@/benchmarks/harness';
+
+// In-memory stand-in for a ws socket. With `flushing` off, writes stay
+// "in flight" until flush() runs their callbacks, like a client that has
+// stopped reading.
+class FakeSocket implements RealtimeSocket {
+  sent: Buffer[] = [];
+  flushing = true;
+  private callbacks: (() => void)[] = [];
+  private handlers: Record<string, (data?: any) => void> = {};
+
+  send(data: Buffer, options: { binary: boolean }, callback: () => void) {
+    this.sent.push(data);
+    if (this.flushing) {
+      callback();
+    } else {
+      this.callbacks.push(callback);
+    }
+  }
+
+  on(event: string, listener: (data?: any) => void) {
+    this.handlers[event] = listener;
+  }
+
+  ping() {}
+
+  terminate() {}
+
+  emit(event: string, data?: unknown) {
+    this.handlers[event](data);
+  }
+
+  subscribe(topics: string[]) {
+    this.emit('message', Buffer.from(JSON.stringify({ type: 'SUBSCRIBE', topics })));
+  }
+
+  flush() {
+    this.flushing = true;
+    const callbacks = this.callbacks;
+    this.callbacks = [];
+    callbacks.forEach(callback => callback());
+  }
+
+  messages(type?: string): WebSocketMessage[] {
+    return this.sent
+      .map(frame => JSON.parse(frame.toString()) as WebSocketMessage)
+      .filter(message => !type || message.type === type);
+  }
+}
+
+describe('RealtimeGateway', () => {
+  let repository: PostRepository;
+  let gateway: RealtimeGateway;
+
+  const connect = (topics: string[]) => {
+    const socket = new FakeSocket();
+    gateway.connect(socket, 'user');
+    socket.subscribe(topics);
+    socket.sent = [];
+    return socket;
+  };
+
+  beforeEach(() => {
+    repository = new PostRepository(seedPosts(400));
+    gateway = new RealtimeGateway();
+    gateway.watch(repository);
+  });
+
+  afterEach(() => {
+    gateway.close();
+  });
+
+  it('fans one serialized frame out to each subscriber once', () => {
+    const [hot, other] = repository.list();
+    const both = connect([FEED_TOPIC, postTopic(hot.id)]);
+    const postOnly = connect([postTopic(hot.id)]);
+    const unrelated = connect([postTopic(other.id)]);
+
+    repository.setLike(hot.id, 'u1', true);
+
+    expect(both.messages('POST_LIKED')).toHaveLength(1);
+    expect(postOnly.messages('POST_LIKED')).toHaveLength(1);
+    expect(unrelated.sent).toHaveLength(0);
+    // Zero-copy: every connection was handed the same Buffer
+    expect(both.sent[0]).toBe(postOnly.sent[0]);
+    expect(both.messages()[0].payload).toEqual({
+      postId: hot.id,
+      likes: hot.likes + 1,
+      liked: true,
+      epoch: repository.epoch,
+      version: repository.version,
+    });
+  });
+
+  it('coalesces queued likes for a slow consumer into the latest count', () => {
+    const hot = repository.list()[0];
+    const slow = connect([postTopic(hot.id)]);
+    slow.flushing = false;
+
+    // Fill the connection's in-flight budget
+    repository.update(hot.id, { content: 'x'.repeat(300 * 1024) });
+    for (let i = 0; i < 1000; i++) {
+      repository.setLike(hot.id, `liker-${i}`, true);
+    }
+
+    expect(slow.sent).toHaveLength(1);
+    expect(gateway.stats.coalesced).toBe(999);
+
+    slow.flush();
+    const likes = slow.messages('POST_LIKED');
+    expect(likes).toHaveLength(1);
+    expect(likes[0].payload.likes).toBe(hot.likes + 1000);
+  });
+
+  it('keeps frames for one post in sequence order when coalescing', () => {
+    const hot = repository.list()[0];
+    const slow = connect([postTopic(hot.id)]);
+    slow.flushing = false;
+
+    repository.update(hot.id, { content: 'x'.repeat(300 * 1024) });
+    repository.setLike(hot.id, 'a', true);
+    repository.update(hot.id, { title: 'Edited' });
+    repository.setLike(hot.id, 'b', true);
+
+    slow.flush();
+    const received = slow.messages().slice(1);
+    expect(received.map(message => message.type)).toEqual(['POST_UPDATED', 'POST_LIKED']);
+    const seqs = slow.messages().map(message => message.seq);
+    expect(seqs).toEqual(seqs.slice().sort((a, b) => a - b));
+  });
+
+  it('drops the oldest events past the queue bound and asks the client to resync', () => {
+    const posts = repository.list();
+    const slow = connect([FEED_TOPIC]);
+    const fast = connect([FEED_TOPIC]);
+    slow.flushing = false;
+
+    repository.update(posts[0].id, { content: 'x'.repeat(300 * 1024) });
+    posts.slice(1).forEach(post => repository.setLike(post.id, 'u1', true));
+
+    expect(fast.messages('POST_LIKED')).toHaveLength(posts.length - 1);
+    expect(gateway.stats.dropped).toBeGreaterThan(0);
+
+    slow.flush();
+    const received = slow.messages();
+    expect(received[received.length - 1].type).toBe('RESYNC');
+    expect(received.length).toBeLessThan(posts.length);
+  });
+
+  it('relays typing to other subscribers of the post and forgets closed connections', () => {
+    const post = repository.list()[0];
+    const typist = connect([postTopic(post.id)]);
+    const reader = connect([postTopic(post.id)]);
+
+    typist.emit('message', Buffer.from(JSON.stringify({ type: 'USER_TYPING', payload: { postId: post.id } })));
+    expect(reader.messages('USER_TYPING')).toHaveLength(1);
+    expect(typist.messages('USER_TYPING')).toHaveLength(0);
+
+    typist.emit('close');
+    expect(gateway.subscriberCount(postTopic(post.id))).toBe(1);
+    expect(gateway.stats.connections).toBe(1);
+  });
+
+  it('relays only whitelisted, size-checked fields of client messages', () => {
+    const post = repository.list()[0];
+    const author = connect([postTopic(post.id)]);
+    const reader = connect([postTopic(post.id)]);
+    const send = (message: unknown) => author.emit('message', Buffer.from(JSON.stringify(message)));
+
+    send({ type: 'COMMENT_ADDED', payload: { postId: post.id, commentId: 'c1', content: 'Nice', html: '<script>' } });
+    send({ type: 'COMMENT_ADDED', payload: { postId: post.id, commentId: 'c2', content: 'x'.repeat(1001) } });
+    send({ type: 'COMMENT_ADDED', payload: { postId: 'p'.repeat(65), commentId: 'c3', content: 'Hi' } });
+    send({ type: 'USER_TYPING', payload: { postId: post.id, typing: false, junk: [1, 2, 3] } });
+    send(null);
+
+    expect(reader.messages('COMMENT_ADDED').map(message => message.payload)).toEqual([
+      { postId: post.id, commentId: 'c1', content: 'Nice' },
+    ]);
+    expect(reader.messages('USER_TYPING').map(message => message.payload)).toEqual([{ postId: post.id, typing: false }]);
+  });
+});
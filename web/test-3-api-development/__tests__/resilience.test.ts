@@ -0,0 +1,167 @@
+/**
+ * @jest-environment node
+ */
+import { apiRequest, retryPolicy } from '@/utils/api';
+import { CircuitBreaker, backoffDelay } from '@/utils/resilience';
+
+// Answers fetch() with the given statuses in turn (then 200s)
+function mockFetch(statuses: number[]) {
+  const fetchMock = jest.fn(async () => {
+    const status = statuses.length ? (statuses.shift() as number) : 200;
+    return {
+      ok: status < 400,
+      status,
+      headers: { get: () => null },
+      json: async () => ({ success: status < 400 }),
+    };
+  });
+  (global as any).fetch = fetchMock;
+  return fetchMock;
+}
+
+describe('backoffDelay', () => {
+  it('draws from the whole capped exponential window', () => {
+    expect(backoffDelay(0, 100, 1000, () => 0.999)).toBe(99);
+    expect(backoffDelay(3, 100, 1000, () => 0.5)).toBe(400);
+    expect(backoffDelay(10, 100, 1000, () => 0.999)).toBe(999);
+    expect(backoffDelay(2, 100, 1000, () => 0)).toBe(0);
+  });
+});
+
+describe('CircuitBreaker', () => {
+  it('opens after repeated failures and lets one probe through after the cooldown', () => {
+    let clock = 0;
+    const breaker = new CircuitBreaker({ failureThreshold: 3, cooldown: 1000, now: () => clock });
+
+    breaker.failure();
+    breaker.failure();
+    expect(breaker.allow()).toBe(true);
+    breaker.failure();
+    expect(breaker.state).toBe('open');
+    expect(breaker.allow()).toBe(false);
+
+    clock = 1000;
+    expect(breaker.allow()).toBe(true);
+    expect(breaker.allow()).toBe(false);
+    breaker.failure();
+    expect(breaker.state).toBe('open');
+
+    clock = 2000;
+    expect(breaker.allow()).toBe(true);
+    breaker.success();
+    expect(breaker.state).toBe('closed');
+  });
+
+  it('frees the half-open probe when its request is cancelled', () => {
+    let clock = 0;
+    const breaker = new CircuitBreaker({ failureThreshold: 1, cooldown: 1000, now: () => clock });
+
+    breaker.failure();
+    clock = 1000;
+    expect(breaker.allow()).toBe(true);
+    breaker.cancel();
+    expect(breaker.state).toBe('half-open');
+    expect(breaker.allow()).toBe(true);
+  });
+});
+
+describe('apiRequest retries', () => {
+  const defaults = { ...retryPolicy };
+
+  beforeEach(() => {
+    retryPolicy.baseDelay = 1;
+    retryPolicy.maxDelay = 5;
+  });
+
+  afterAll(() => {
+    Object.assign(retryPolicy, defaults);
+  });
+
+  it('retries transient failures of idempotent requests', async () => {
+    const fetchMock = mockFetch([503, 502]);
+    await expect(apiRequest('/api/retry/get')).resolves.toEqual({ success: true });
+    expect(fetchMock).toHaveBeenCalledTimes(3);
+  });
+
+  it('does not retry a POST or a client error', async () => {
+    let fetchMock = mockFetch([503]);
+    await expect(apiRequest('/api/retry/post', { method: 'POST' })).rejects.toMatchObject({ status: 503 });
+    expect(fetchMock).toHaveBeenCalledTimes(1);
+
+    fetchMock = mockFetch([404]);
+    await expect(apiRequest('/api/retry/missing')).rejects.toMatchObject({ status: 404 });
+    expect(fetchMock).toHaveBeenCalledTimes(1);
+  });
+
+  it('fails fast once the endpoint circuit is open', async () => {
+    const fetchMock = mockFetch(new Array(20).fill(500));
+
+    await expect(apiRequest('/api/retry/down', { retries: 1 })).rejects.toMatchObject({ status: 500 });
+    await expect(apiRequest('/api/retry/down', { retries: 1 })).rejects.toMatchObject({ status: 500 });
+    await expect(apiRequest('/api/retry/down', { retries: 0 })).rejects.toMatchObject({ status: 500 });
+    expect(fetchMock).toHaveBeenCalledTimes(5);
+
+    await expect(apiRequest('/api/retry/down')).rejects.toMatchObject({ status: 503 });
+    expect(fetchMock).toHaveBeenCalledTimes(5);
+  });
+
+  it('releases the probe when the caller aborts it', async () => {
+    mockFetch(new Array(5).fill(500));
+    for (let i = 0; i < 5; i++) {
+      await expect(apiRequest('/api/retry/aborted', { retries: 0 })).rejects.toMatchObject({ status: 500 });
+    }
+    await expect(apiRequest('/api/retry/aborted')).rejects.toMatchObject({ status: 503 });
+
+    // Skip the cooldown so the next request is the half-open probe
+    const now = Date.now();
+    const clock = jest.spyOn(Date, 'now').mockReturnValue(now + 60000);
+    try {
+      const controller = new AbortController();
+      (global as any).fetch = jest.fn(
+        (url: string, init: RequestInit) =>
+          new Promise((resolve, reject) => {
+            init.signal?.addEventListener('abort', () => reject(new Error('aborted')));
+          })
+      );
+      const probe = apiRequest('/api/retry/aborted', { signal: controller.signal });
+      controller.abort();
+      await expect(probe).rejects.toThrow('aborted');
+
+      const fetchMock = mockFetch([]);
+      await expect(apiRequest('/api/retry/aborted')).resolves.toEqual({ success: true });
+      expect(fetchMock).toHaveBeenCalledTimes(1);
+    } finally {
+      clock.mockRestore();
+    }
+  });
+
+  it('does not share a GET that carries its own signal', async () => {
+    (global as any).fetch = jest.fn(
+      (url: string, init: RequestInit) =>
+        new Promise((resolve, reject) => {
+          init.signal?.addEventListener('abort', () => reject(new Error('aborted')));
+          const response = { ok: true, status: 200, headers: { get: () => null }, json: async () => ({ success: true }) };
+          setTimeout(() => resolve(response), 10);
+        })
+    );
+    const controller = new AbortController();
+    const abandoned = apiRequest('/api/retry/shared', { signal: controller.signal });
+    const kept = apiRequest('/api/retry/shared');
+    controller.abort();
+
+    await expect(abandoned).rejects.toThrow('aborted');
+    await expect(kept).resolves.toEqual({ success: true });
+    expect((global as any).fetch).toHaveBeenCalledTimes(2);
+  });
+
+  it('gives up when the deadline passes', async () => {
+    (global as any).fetch = jest.fn(
+      (url: string, init: RequestInit) =>
+        new Promise((resolve, reject) => {
+          init.signal?.addEventListener('abort', () => reject(new Error('aborted')));
+        })
+    );
+
+    await expect(apiRequest('/api/retry/slow', { timeout: 20 })).rejects.toMatchObject({ status: 0 });
+  });
+});
@@ -0,0 +1,93 @@
+import { CacheEntry, CachePersistence, ResponseCache } from '@/utils/responseCache';
+
+const flush = () => new Promise(resolve => setTimeout(resolve, 0));
+
+describe('ResponseCache', () => {
+  let clock: number;
+  const now = () => clock;
+
+  beforeEach(() => {
+    clock = 0;
+  });
+
+  it('serves fresh hits, then stale values while revalidating', async () => {
+    const cache = new ResponseCache({ ttl: 1000, now });
+    let version = 0;
+    const fetcher = jest.fn(async () => ++version);
+    const updates: unknown[] = [];
+    cache.subscribe((key, value) => updates.push(value));
+
+    expect(await cache.get('/a', fetcher)).toBe(1);
+    clock = 500;
+    expect(await cache.get('/a', fetcher)).toBe(1);
+    expect(fetcher).toHaveBeenCalledTimes(1);
+
+    clock = 1500;
+    expect(await cache.get('/a', fetcher)).toBe(1);
+    await flush();
+    expect(updates).toEqual([2]);
+    expect(await cache.get('/a', fetcher)).toBe(2);
+
+    expect(cache.stats).toMatchObject({ hits: 2, staleHits: 1, misses: 1, revalidations: 1 });
+  });
+
+  it('evicts least recently used entries by count and by bytes', async () => {
+    const cache = new ResponseCache({ maxEntries: 3, maxBytes: 1000, now });
+    const value = (text: string) => async () => text;
+
+    await cache.get('/a', value('a'));
+    await cache.get('/b', value('b'));
+    await cache.get('/c', value('c'));
+    await cache.get('/a', value('a')); // touch: /b is now the oldest
+    await cache.get('/d', value('d'));
+
+    expect(cache.size).toBe(3);
+    expect(cache.stats.evictions).toBe(1);
+    const miss = jest.fn(async () => 'b');
+    await cache.get('/b', miss);
+    expect(miss).toHaveBeenCalled();
+
+    // 996 bytes: pushes everything else out
+    await cache.get('/big', value('x'.repeat(496)));
+    expect(cache.size).toBe(1);
+    expect(cache.byteSize).toBeLessThanOrEqual(1000);
+  });
+
+  it('discards responses that were in flight during an invalidation', async () => {
+    const cache = new ResponseCache({ now });
+    let release: (value: string) => void = () => undefined;
+    const slow = () => new Promise<string>(resolve => (release = resolve));
+
+    const pending = cache.get('/api/posts', slow);
+    await flush();
+    cache.invalidate('/api/posts');
+    release('old');
+    expect(await pending).toBe('old');
+
+    const fetcher = jest.fn(async () => 'new');
+    expect(await cache.get('/api/posts', fetcher)).toBe('new');
+    expect(fetcher).toHaveBeenCalledTimes(1);
+  });
+
+  it('loads persisted entries and mirrors writes', async () => {
+    const saved = new Map<string, CacheEntry>([['/a', { value: 'persisted', storedAt: -5000, size: 18 }]]);
+    const persistence: CachePersistence = {
+      load: async () => Array.from(saved.entries()),
+      save: async (key, entry) => {
+        saved.set(key, entry);
+      },
+      remove: async keys => keys.forEach(key => saved.delete(key)),
+    };
+    const cache = new ResponseCache({ ttl: 1000, persistence, now });
+
+    // Stale, but rendered immediately and refreshed in the background
+    const fetcher = jest.fn(async () => 'fresh');
+    expect(await cache.get('/a', fetcher)).toBe('persisted');
+    await flush();
+    expect(saved.get('/a')?.value).toBe('fresh');
+
+    cache.invalidate();
+    await flush();
+    expect(saved.size).toBe(0);
+  });
+});
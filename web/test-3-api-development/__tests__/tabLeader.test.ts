@@ -0,0 +1,122 @@
+import { ChannelLike, LockManagerLike, TabLeader } from '@/utils/tabLeader';
+import { diffPosts } from '@/store/tabSync';
+import { usePostsStore } from '@/store/posts';
+import { mockPosts } from '@/utils/mockData';
+
+// Grants one exclusive lock at a time, in request order, like navigator.locks
+class FakeLocks implements LockManagerLike {
+  private held = false;
+  private waiting: { callback: () => Promise<void>; done: () => void }[] = [];
+
+  request(name: string, options: { signal?: AbortSignal }, callback: () => Promise<void>) {
+    return new Promise<void>((resolve, reject) => {
+      const waiter = { callback, done: resolve };
+      this.waiting.push(waiter);
+      if (options.signal) {
+        options.signal.addEventListener('abort', () => {
+          const index = this.waiting.indexOf(waiter);
+          if (index !== -1) {
+            this.waiting.splice(index, 1);
+            reject(new Error('AbortError'));
+          }
+        });
+      }
+      this.grant();
+    });
+  }
+
+  private grant() {
+    if (this.held || this.waiting.length === 0) {
+      return;
+    }
+    const waiter = this.waiting.shift()!;
+    this.held = true;
+    waiter.callback().then(() => {
+      this.held = false;
+      waiter.done();
+      this.grant();
+    });
+  }
+}
+
+// Delivers each message to every other channel of the same name
+function channelHub() {
+  const channels: ChannelLike[] = [];
+  return (name: string): ChannelLike => {
+    const channel: ChannelLike = {
+      onmessage: null,
+      postMessage: message => {
+        channels.forEach(other => {
+          if (other !== channel && other.onmessage) {
+            other.onmessage({ data: message });
+          }
+        });
+      },
+      close: () => {
+        channels.splice(channels.indexOf(channel), 1);
+      },
+    };
+    channels.push(channel);
+    return channel;
+  };
+}
+
+const flush = () => new Promise(resolve => setTimeout(resolve, 0));
+
+describe('TabLeader', () => {
+  it('elects one leader and hands over when it closes', async () => {
+    const locks = new FakeLocks();
+    const createChannel = channelHub();
+    const tabs = [0, 1, 2].map(() => new TabLeader<string>('sync', { locks, createChannel }));
+    const changes: string[] = [];
+    tabs.forEach((tab, index) => tab.onLeadershipChange(leader => changes.push(`${index}:${leader}`)));
+
+    tabs.forEach(tab => tab.start());
+    await flush();
+    expect(tabs.map(tab => tab.isLeader)).toEqual([true, false, false]);
+
+    tabs[0].close();
+    await flush();
+    expect(tabs[1].isLeader).toBe(true);
+
+    // A waiting tab that closes never becomes leader
+    tabs[2].close();
+    tabs[1].close();
+    await flush();
+    expect(changes).toEqual(['0:true', '0:false', '1:true', '1:false']);
+  });
+
+  it('broadcasts to the other tabs only', async () => {
+    const createChannel = channelHub();
+    const [first, second, third] = [0, 1, 2].map(() => new TabLeader<string>('sync', { locks: null, createChannel }));
+    const received: string[] = [];
+    [first, second, third].forEach((tab, index) => {
+      tab.onMessage(message => received.push(`${index}<-${message}`));
+      tab.start();
+    });
+
+    first.post('patch');
+    expect(received).toEqual(['1<-patch', '2<-patch']);
+    // Without Web Locks every tab leads itself
+    expect(second.isLeader).toBe(true);
+  });
+});
+
+describe('diffPosts', () => {
+  it('reports only the posts that were replaced or removed', () => {
+    usePostsStore.getState().receivePosts(mockPosts);
+    const initial = usePostsStore.getState();
+    const [liked, removed] = initial.orderedIds;
+
+    usePostsStore.getState().likePost(liked, 'someone');
+    usePostsStore.getState().deletePost(removed);
+    const patch = diffPosts(initial, usePostsStore.getState());
+
+    expect(patch!.posts.map(post => post.id)).toEqual([liked]);
+    expect(patch!.posts[0].author).toEqual(mockPosts.find(post => post.id === liked)!.author);
+    expect(patch!.deleted).toEqual([removed]);
+    expect(diffPosts(initial, initial)).toBeNull();
+
+    usePostsStore.setState(initial, true);
+  });
+});
@@ -0,0 +1,71 @@
+/**
+ * @jest-environment node
+ */
+import postsHandler, { config } from '@/pages/api/posts';
+import postHandler from '@/pages/api/posts/[id]';
+import { getPostRepository, PostRepository, setPostRepository } from '@/server/postRepository';
+import { checkCreatePost, checkUpdatePost } from '@/utils/validation';
+import { mockPosts } from '@/utils/mockData';
+import { createRequest, createResponse } from '@/benchmarks/harness';
+
+describe('compiled post validators', () => {
+  it('accepts valid bodies', () => {
+    expect(checkCreatePost({ title: 'Hello', content: 'World' })).toBeNull();
+    expect(checkCreatePost({ title: 'Hello', content: 'World', imageUrl: 'https://a.example/b/c.PNG?v=2' })).toBeNull();
+    // Resizing CDN images have no file extension
+    expect(checkCreatePost({ title: 'Hello', content: 'World', imageUrl: mockPosts[0].imageUrl })).toBeNull();
+    expect(checkUpdatePost({})).toBeNull();
+    expect(checkUpdatePost({ imageUrl: '' })).toBeNull();
+  });
+
+  it('reports every invalid field', () => {
+    expect(checkCreatePost({ title: '  ', content: 'x'.repeat(5001), imageUrl: 'ftp://a/b.jpg' })).toEqual([
+      'Title is required',
+      'Content must be at most 5000 characters',
+      'Image URL must be a valid image URL',
+    ]);
+    expect(checkCreatePost({ title: 42, content: null })).toEqual([
+      'Title must be a string',
+      'Content must be a string',
+    ]);
+    expect(checkUpdatePost({ title: '' })).toEqual(['Title cannot be empty']);
+    expect(checkUpdatePost({ imageUrl: ' ' })).toEqual(['Image URL must be a valid image URL']);
+  });
+
+  it('rejects bodies that are not objects', () => {
+    expect(checkCreatePost(undefined)).toEqual(['Request body must be a JSON object']);
+    expect(checkCreatePost('title=Hello')).toEqual(['Request body must be a JSON object']);
+    expect(checkUpdatePost([])).toEqual(['Request body must be a JSON object']);
+  });
+});
+
+describe('post write endpoints', () => {
+  beforeEach(() => {
+    setPostRepository(new PostRepository(mockPosts));
+  });
+
+  it('limits request bodies before parsing', () => {
+    expect(config.api.bodyParser.sizeLimit).toBe('64kb');
+  });
+
+  it('rejects an invalid create with 400 and stores nothing', async () => {
+    const res = createResponse();
+    await postsHandler(createRequest('POST', {}, { title: 'Hello', content: 7 }), res);
+
+    expect(res.statusCode).toBe(400);
+    expect(res.body).toEqual({ success: false, error: 'Content must be a string' });
+    expect(getPostRepository().count()).toBe(mockPosts.length);
+  });
+
+  it('rejects an invalid update with 400 and leaves the post alone', async () => {
+    const res = createResponse();
+    await postHandler(createRequest('PUT', { id: '1' }, { title: 'x'.repeat(201) }), res);
+
+    expect(res.statusCode).toBe(400);
+    expect(res.body).toEqual({ success: false, error: 'Title must be at most 200 characters' });
+
+    const read = createResponse();
+    postHandler(createRequest('GET', { id: '1' }), read);
+    expect((read.body as { data: { title: string } }).data.title).toBe(mockPosts[0].title);
+  });
+});
@@ -0,0 +1,191 @@
+import { RealtimeConnection, WebSocketLike } from '@/utils/websocket';
+
+class FakeWebSocket implements WebSocketLike {
+  readyState = 0;
+  sent: any[] = [];
+  closed = false;
+  onopen: ((event: unknown) => void) | null = null;
+  onclose: ((event: unknown) => void) | null = null;
+  onerror: ((event: unknown) => void) | null = null;
+  onmessage: ((event: { data: unknown }) => void) | null = null;
+
+  send(data: string) {
+    this.sent.push(JSON.parse(data));
+  }
+
+  close() {
+    this.closed = true;
+    this.readyState = 3;
+  }
+
+  open() {
+    this.readyState = 1;
+    this.onopen?.({});
+  }
+
+  // The server (or network) drops the connection
+  drop() {
+    this.readyState = 3;
+    this.onclose?.({});
+  }
+
+  receive(message: object) {
+    this.onmessage?.({ data: JSON.stringify({ timestamp: Date.now(), messageId: 'm', userId: '', seq: 1, ...message }) });
+  }
+}
+
+describe('RealtimeConnection', () => {
+  let sockets: FakeWebSocket[];
+  let hidden: boolean;
+  let connection: RealtimeConnection;
+
+  const latest = () => sockets[sockets.length - 1];
+  // Let the prepare() promise resolve
+  const settle = () => Promise.resolve().then(() => undefined);
+
+  const create = (random = () => 0.5) => {
+    connection = new RealtimeConnection({
+      url: 'ws://test/api/realtime',
+      createSocket: () => {
+        const socket = new FakeWebSocket();
+        sockets.push(socket);
+        return socket;
+      },
+      baseDelay: 1000,
+      maxDelay: 30000,
+      heartbeatInterval: 25000,
+      heartbeatTimeout: 10000,
+      hiddenGracePeriod: 15000,
+      random,
+    });
+    connection.start();
+    return connection;
+  };
+
+  beforeEach(() => {
+    jest.useFakeTimers();
+    sockets = [];
+    hidden = false;
+    Object.defineProperty(document, 'hidden', { configurable: true, get: () => hidden });
+  });
+
+  afterEach(() => {
+    connection.close();
+    jest.useRealTimers();
+  });
+
+  it('multiplexes topic listeners and re-subscribes after a reconnect', async () => {
+    create();
+    const feed = jest.fn();
+    const post = jest.fn();
+    const unsubscribeFeed = connection.subscribe('feed', feed);
+    const unsubscribePost = connection.subscribe('post:1', post);
+    connection.subscribe('post:1', jest.fn());
+
+    await settle();
+    expect(sockets).toHaveLength(1);
+    latest().open();
+    expect(connection.state).toBe('connected');
+    expect(latest().sent).toEqual([{ type: 'SUBSCRIBE', topics: ['feed', 'post:1'] }]);
+
+    latest().receive({ type: 'POST_LIKED', payload: { postId: '1', likes: 3, liked: true } });
+    latest().receive({ type: 'POST_CREATED', payload: { post: { id: '2' } } });
+    expect(feed).toHaveBeenCalledTimes(2);
+    expect(post).toHaveBeenCalledTimes(1);
+
+    unsubscribeFeed();
+    unsubscribePost();
+    expect(latest().sent.slice(1)).toEqual([{ type: 'UNSUBSCRIBE', topics: ['feed'] }]);
+
+    latest().drop();
+    expect(connection.state).toBe('reconnecting');
+    jest.advanceTimersByTime(1000);
+    await settle();
+    latest().open();
+    expect(latest().sent).toEqual([{ type: 'SUBSCRIBE', topics: ['post:1'] }]);
+  });
+
+  it('backs off with jitter between failed attempts', async () => {
+    const draws = [0.9, 0.9, 0.9, 0.1, 0.1];
+    create(() => draws.shift() as number);
+    await settle();
+
+    // Attempt windows: 1s, 2s, 4s, 8s (full jitter)
+    const delays = [900, 1800, 3600, 800];
+    for (const delay of delays) {
+      const count = sockets.length;
+      latest().drop();
+      jest.advanceTimersByTime(delay - 1);
+      await settle();
+      expect(sockets).toHaveLength(count);
+      jest.advanceTimersByTime(1);
+      await settle();
+      expect(sockets).toHaveLength(count + 1);
+    }
+
+    // A successful connection resets the backoff
+    latest().open();
+    latest().drop();
+    jest.advanceTimersByTime(100);
+    await settle();
+    expect(sockets).toHaveLength(6);
+  });
+
+  it('pings while idle and drops a connection that stops answering', async () => {
+    create();
+    await settle();
+    latest().open();
+
+    jest.advanceTimersByTime(25000);
+    expect(latest().sent).toEqual([{ type: 'PING', id: '1' }]);
+    latest().receive({ type: 'PONG', payload: { id: '1' } });
+
+    // No more traffic: the next ping goes out, the one after gives up
+    jest.advanceTimersByTime(50000);
+    expect(latest().closed).toBe(true);
+    expect(connection.state).toBe('reconnecting');
+  });
+
+  it('releases the socket while the tab stays hidden and reconnects when visible', async () => {
+    create();
+    await settle();
+    latest().open();
+
+    hidden = true;
+    document.dispatchEvent(new Event('visibilitychange'));
+    jest.advanceTimersByTime(14999);
+    expect(connection.state).toBe('connected');
+    jest.advanceTimersByTime(1);
+    expect(connection.state).toBe('suspended');
+    expect(latest().closed).toBe(true);
+
+    // Nothing reconnects while hidden
+    jest.advanceTimersByTime(60000);
+    await settle();
+    expect(sockets).toHaveLength(1);
+
+    hidden = false;
+    document.dispatchEvent(new Event('visibilitychange'));
+    await settle();
+    expect(sockets).toHaveLength(2);
+    latest().open();
+    expect(connection.state).toBe('connected');
+  });
+
+  it('ignores events from a socket it has already replaced', async () => {
+    create();
+    await settle();
+    const stale = latest();
+    stale.drop();
+    jest.advanceTimersByTime(1000);
+    await settle();
+    latest().open();
+
+    const listener = jest.fn();
+    connection.onMessage(listener);
+    stale.receive({ type: 'POST_DELETED', payload: { postId: '1' } });
+    stale.drop();
+    expect(listener).not.toHaveBeenCalled();
+    expect(connection.state).toBe('connected');
+  });
+});
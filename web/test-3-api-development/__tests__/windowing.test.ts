@@ -0,0 +1,104 @@
+import { RowLayout } from '@/utils/windowing';
+
+describe('RowLayout', () => {
+  const heights = [100, 200, 50, 150];
+  const keys = ['a', 'b', 'c', 'd'];
+
+  function createLayout() {
+    const layout = new RowLayout();
+    layout.setKeys(keys, index => heights[index]);
+    return layout;
+  }
+
+  it('computes offsets from the row heights', () => {
+    const layout = createLayout();
+
+    expect(layout.offsetOf(0)).toBe(0);
+    expect(layout.offsetOf(1)).toBe(100);
+    expect(layout.offsetOf(3)).toBe(350);
+    expect(layout.totalHeight).toBe(500);
+  });
+
+  it('finds the row covering a scroll offset', () => {
+    const layout = createLayout();
+
+    expect(layout.indexAt(-20)).toBe(0);
+    expect(layout.indexAt(0)).toBe(0);
+    expect(layout.indexAt(99)).toBe(0);
+    expect(layout.indexAt(100)).toBe(1);
+    expect(layout.indexAt(320)).toBe(2);
+    expect(layout.indexAt(10000)).toBe(3);
+  });
+
+  it('updates offsets when a row is measured', () => {
+    const layout = createLayout();
+
+    expect(layout.setHeight('b', 260)).toBe(60);
+    expect(layout.setHeight('b', 260)).toBe(0);
+    expect(layout.offsetOf(2)).toBe(360);
+    expect(layout.totalHeight).toBe(560);
+  });
+
+  it('keeps measured heights when rows are prepended', () => {
+    const layout = createLayout();
+    layout.setHeight('c', 80);
+
+    layout.setKeys(['new', ...keys], () => 300);
+
+    expect(layout.indexOf('c')).toBe(3);
+    expect(layout.offsetOf(3)).toBe(300 + 300 + 300);
+    expect(layout.offsetOf(4) - layout.offsetOf(3)).toBe(80);
+  });
+
+  it('forgets heights of removed rows once past the cap', () => {
+    const layout = new RowLayout(new Map(), 2);
+    keys.forEach(key => layout.setHeight(key, 10));
+
+    // Two detached rows are within the cap; three are not
+    layout.setKeys(['a', 'b'], () => 300);
+    layout.pruneMeasured();
+    layout.setKeys(keys, () => 300);
+    expect(layout.totalHeight).toBe(40);
+
+    layout.setKeys(['a'], () => 300);
+    layout.pruneMeasured();
+    layout.setKeys(keys, () => 300);
+    expect(layout.totalHeight).toBe(10 + 3 * 300);
+  });
+
+  it('takes heights another layout measured after it was built', () => {
+    const measured = new Map<string, number>();
+    const current = new RowLayout(measured);
+    current.setKeys(keys, () => 300);
+    const next = new RowLayout(measured);
+    next.setKeys(['new', ...keys], () => 300);
+
+    current.setHeight('b', 50);
+    expect(next.totalHeight).toBe(5 * 300);
+
+    expect(next.syncMeasured()).toBe(true);
+    expect(next.totalHeight).toBe(4 * 300 + 50);
+    expect(next.syncMeasured()).toBe(false);
+  });
+
+  it('matches a linear scan on a large list', () => {
+    const count = 50000;
+    const layout = new RowLayout();
+    const rowHeight = (index: number) => (index % 3 === 0 ? 580 : 260);
+    layout.setKeys(
+      Array.from({ length: count }, (_, index) => `post-${index}`),
+      rowHeight
+    );
+
+    let offset = 0;
+    for (let index = 0; index < count; index++) {
+      if (index % 997 === 0) {
+        expect(layout.offsetOf(index)).toBe(offset);
+        expect(layout.indexAt(offset)).toBe(index);
+        expect(layout.indexAt(offset + rowHeight(index) - 1)).toBe(index);
+      }
+      offset += rowHeight(index);
+    }
+    expect(layout.totalHeight).toBe(offset);
+  });
+});
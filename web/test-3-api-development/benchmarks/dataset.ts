@@ -0,0 +1,65 @@
+import fs from 'fs';
+import { performance } from 'perf_hooks';
+import { DatasetGenerator, DatasetRecord } from '@/utils/dataset';
+import { argNumber, argString, writeDatasetLog } from './harness';
+
+// Writes a synthetic dataset (utils/dataset.ts) for scale tests:
+//
+//   npm run dataset -- --users=1000000 --posts=1000000 --out=dataset.ndjson
+//   npm run dataset -- --posts=100000 --into=.data    # then `npm start`
+//
+// --out streams every record (users, posts, comments) as one JSON object
+// per line; `--out=-` writes to stdout. --into writes the posts into a data
+// directory the API server replays on start (POSTS_DATA_DIR). The same
+// --seed and sizes always produce the same dataset.
+
+const options = {
+  seed: argNumber('seed', 1),
+  users: argNumber('users', 1000),
+  posts: argNumber('posts', 10000),
+  imageRatio: argNumber('image-ratio', 0.35),
+  days: argNumber('days', 365),
+};
+const out = argString('out', '');
+const into = argString('into', '');
+
+// NDJSON to `file`, waiting for the stream to drain whenever it is full
+async function writeNdjson(generator: DatasetGenerator, file: string) {
+  const stream = file === '-' ? process.stdout : fs.createWriteStream(file);
+  const stats = await generator.generate((record: DatasetRecord) => {
+    if (stream.write(JSON.stringify(record) + '\n')) {
+      return undefined;
+    }
+    return new Promise<void>(resolve => stream.once('drain', () => resolve()));
+  });
+  if (stream !== process.stdout) {
+    await new Promise<void>((resolve, reject) => {
+      stream.on('error', reject);
+      stream.end(() => resolve());
+    });
+  }
+  return stats;
+}
+
+async function main() {
+  if (!out === !into) {
+    throw new Error('Pass exactly one of --out=<file.ndjson> or --into=<data dir>');
+  }
+
+  const start = performance.now();
+  const stats = out
+    ? await writeNdjson(new DatasetGenerator(options), out)
+    : await writeDatasetLog(into, new DatasetGenerator({ ...options, comments: false }));
+  const seconds = (performance.now() - start) / 1000;
+
+  // stderr, so `--out=-` output stays clean
+  console.error(
+    `${stats.users} users, ${stats.posts} posts, ${stats.likes} likes, ${stats.comments} comments ` +
+      `in ${seconds.toFixed(1)}s -> ${out || into}`
+  );
+}
+
+main().catch(error => {
+  console.error(error);
+  process.exit(1);
+});
@@ -0,0 +1,204 @@
+import type { NextApiRequest, NextApiResponse } from 'next';
+import { performance } from 'perf_hooks';
+import { PostOperation, PostRepository } from '@/server/postRepository';
+import { WriteAheadLog } from '@/server/writeAheadLog';
+import { Post } from '@/types';
+import { DatasetGenerator, DatasetStats } from '@/utils/dataset';
+import { mockUsers } from '@/utils/mockData';
+
+// Shared helpers for the benchmark scripts in this folder.
+// Handlers are invoked in-process with minimal req/res doubles so the
+// numbers measure handler + store cost, not the HTTP stack.
+
+export interface MockResponse {
+  statusCode: number;
+  headers: Record<string, string | string[]>;
+  body: unknown;
+}
+
+export function createRequest(
+  method: string,
+  query: Record<string, string> = {},
+  body?: unknown,
+  headers: Record<string, string> = {}
+): NextApiRequest {
+  return { method, query, body, headers } as unknown as NextApiRequest;
+}
+
+export function createResponse(): NextApiResponse & MockResponse {
+  const res = {
+    statusCode: 200,
+    headers: {} as Record<string, string | string[]>,
+    body: undefined as unknown,
+    status(code: number) {
+      res.statusCode = code;
+      return res;
+    },
+    setHeader(name: string, value: string | string[]) {
+      res.headers[name.toLowerCase()] = value;
+      return res;
+    },
+    json(body: unknown) {
+      res.body = body;
+      return res;
+    },
+    send(body: unknown) {
+      res.body = body;
+      return res;
+    },
+    end() {
+      return res;
+    },
+  };
+  return res as unknown as NextApiResponse & MockResponse;
+}
+
+const WORDS = [
+  'react', 'typescript', 'next', 'server', 'component', 'state', 'hooks', 'api',
+  'design', 'accessibility', 'performance', 'testing', 'database', 'cache',
+  'render', 'stream', 'query', 'index', 'layout', 'mobile', 'browser', 'network',
+  'deploy', 'cloud', 'security', 'animation', 'router', 'store', 'memory', 'async',
+];
+
+// Deterministic pseudo-random sentence built from WORDS
+function sentence(seed: number, length: number): string {
+  const words: string[] = [];
+  let value = seed;
+  for (let i = 0; i < length; i++) {
+    value = (value * 1103515245 + 12345) % 2147483648;
+    words.push(WORDS[value % WORDS.length]);
+  }
+  return words.join(' ');
+}
+
+// Deterministic posts spread over the mock users
+export function seedPosts(count: number, authorId?: string): Post[] {
+  const posts: Post[] = [];
+  const start = Date.parse('2024-01-01T00:00:00Z');
+
+  for (let i = 0; i < count; i++) {
+    const author = authorId
+      ? mockUsers.find(user => user.id === authorId) || mockUsers[0]
+      : mockUsers[i % mockUsers.length];
+    const timestamp = new Date(start + i * 60000).toISOString();
+
+    posts.push({
+      id: `seed-${i}`,
+      title: `${sentence(i, 4)} ${i}`,
+      content: sentence(i * 31 + 7, 24),
+      authorId: author.id,
+      author,
+      likes: (i * 7919) % 1000,
+      likedBy: [],
+      createdAt: timestamp,
+      updatedAt: timestamp,
+    });
+  }
+  return posts;
+}
+
+// Seedable pseudo-random numbers, shared with the dataset generator
+export { createRandom } from '@/utils/dataset';
+
+// Inserts the posts of a generated dataset into `repository`
+export function loadDataset(repository: PostRepository, generator: DatasetGenerator): Promise<DatasetStats> {
+  return generator.generate(record => {
+    if (record.type === 'post') {
+      repository.insert(record.post);
+    }
+  });
+}
+
+// Writes the posts of a generated dataset to a data directory as
+// write-ahead log inserts, which `next start` replays with POSTS_DATA_DIR
+export async function writeDatasetLog(dir: string, generator: DatasetGenerator): Promise<DatasetStats> {
+  const wal = new WriteAheadLog<PostOperation>(dir);
+  wal.load(() => undefined, () => undefined);
+  await wal.open();
+  let appended = 0;
+  const stats = await generator.generate(record => {
+    if (record.type !== 'post') {
+      return undefined;
+    }
+    wal.append({ op: 'insert', post: record.post });
+    // Flush in batches rather than buffering the whole dataset
+    return ++appended % 10000 === 0 ? wal.sync() : undefined;
+  });
+  await wal.close();
+  return stats;
+}
+
+export function percentile(sortedSamples: number[], p: number): number {
+  if (sortedSamples.length === 0) {
+    return 0;
+  }
+  const index = Math.min(
+    sortedSamples.length - 1,
+    Math.ceil((p / 100) * sortedSamples.length) - 1
+  );
+  return sortedSamples[Math.max(0, index)];
+}
+
+// Run `fn` `iterations` times and print p50/p99 latency in microseconds
+export function measure(label: string, iterations: number, fn: (i: number) => void) {
+  const samples: number[] = [];
+
+  for (let i = 0; i < iterations; i++) {
+    const start = performance.now();
+    fn(i);
+    samples.push((performance.now() - start) * 1000);
+  }
+
+  return report(label, iterations, samples);
+}
+
+// As `measure`, for handlers that finish asynchronously: each iteration
+// is timed until its promise settles, and the next starts after it
+export async function measureAsync(label: string, iterations: number, fn: (i: number) => Promise<unknown>) {
+  const samples: number[] = [];
+
+  for (let i = 0; i < iterations; i++) {
+    const start = performance.now();
+    await fn(i);
+    samples.push((performance.now() - start) * 1000);
+  }
+
+  return report(label, iterations, samples);
+}
+
+function report(label: string, iterations: number, samples: number[]) {
+  samples.sort((a, b) => a - b);
+  const result = {
+    label,
+    iterations,
+    p50: percentile(samples, 50),
+    p99: percentile(samples, 99),
+  };
+
+  console.log(
+    `${label}  n=${iterations}  p50=${result.p50.toFixed(1)}µs  p99=${result.p99.toFixed(1)}µs`
+  );
+  return result;
+}
+
+// Throws unless the handler answered 2xx, so a benchmark never times an
+// error path (a 404, or a 503 from load shedding) by accident
+export function expectOk(label: string, res: MockResponse): void {
+  if (res.statusCode < 200 || res.statusCode >= 300) {
+    throw new Error(`${label}: expected 2xx, got ${res.statusCode} ${JSON.stringify(res.body)}`);
+  }
+}
+
+export function argNumber(name: string, fallback: number): number {
+  return Number(argString(name, String(fallback)));
+}
+
+export function argString(name: string, fallback: string): string {
+  const flag = process.argv.find(arg => arg.startsWith(`--${name}=`));
+  return flag ? flag.slice(name.length + 3) : fallback;
+}
+
+// True for a bare --name
+export function argFlag(name: string): boolean {
+  return process.argv.indexOf(`--${name}`) !== -1;
+}
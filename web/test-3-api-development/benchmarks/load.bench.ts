@@ -0,0 +1,293 @@
+import { ChildProcess, spawn } from 'child_process';
+import fs from 'fs';
+import http from 'http';
+import os from 'os';
+import path from 'path';
+import { performance } from 'perf_hooks';
+import { DatasetGenerator } from '@/utils/dataset';
+import { argFlag, argNumber, argString, createRandom, percentile, writeDatasetLog } from './harness';
+import { Operation, SCENARIOS, buildRequest, createPicker } from './scenarios';
+
+// End-to-end load test of the production server on this machine:
+//   1. writes --posts generated posts by --users authors (utils/dataset.ts)
+//      into a fresh data directory
+//   2. boots `next start` on it (needs a prior `npm run build`)
+//   3. sends the --scenario mix (benchmarks/scenarios.ts) at --rps for
+//      --duration seconds after a --warmup, open loop: requests go out on
+//      schedule whether or not earlier ones finished, and latency is
+//      measured from the scheduled time, so a stalled server cannot hide
+//      its queueing delay by slowing the generator down
+//   4. reports throughput and latency percentiles per operation and
+//      compares them with the scenario's entry in the baseline file
+//
+//   npm run build && npm run bench:load -- --scenario=feed --rps=500
+//   npm run bench:load -- --scenario=feed --rps=500 --update-baseline
+//
+// Exits non-zero when p50/p99 or throughput regress by more than
+// --tolerance (a fraction) against the baseline, or errors increase. A run
+// with no comparable baseline (none recorded for the scenario, or recorded
+// at another rate or data size) fails too, so the gate cannot pass by
+// default; baselines are machine-specific, so record one with
+// --update-baseline on the machine that runs the gate.
+
+const scenarioName = argString('scenario', 'feed');
+const postCount = argNumber('posts', 10000);
+const userCount = argNumber('users', 1000);
+const rps = argNumber('rps', 200);
+const duration = argNumber('duration', 30);
+const warmup = argNumber('warmup', 5);
+const maxInFlight = argNumber('connections', 256);
+const port = argNumber('port', 3100);
+const tolerance = argNumber('tolerance', 0.2);
+const seed = argNumber('seed', 1);
+const baselineFile = path.resolve(argString('baseline', 'benchmarks/load-baseline.json'));
+const updateBaseline = argFlag('update-baseline');
+
+// Latencies this small are noise; regressions must also exceed this
+const LATENCY_SLACK_MS = 1;
+
+interface Sample {
+  op: Operation;
+  ms: number;
+  ok: boolean;
+}
+
+interface Summary {
+  requests: number;
+  throughput: number; // Completed requests per second
+  errorRate: number;
+  p50: number; // ms
+  p90: number;
+  p99: number;
+  max: number;
+}
+
+interface BaselineEntry extends Summary {
+  rps: number;
+  posts: number;
+  users: number;
+}
+
+const agent = new http.Agent({ keepAlive: true, maxSockets: maxInFlight });
+
+function send(method: string, requestPath: string, body?: unknown): Promise<number> {
+  return new Promise(resolve => {
+    const payload = body === undefined ? undefined : JSON.stringify(body);
+    const req = http.request(
+      {
+        host: '127.0.0.1',
+        port,
+        method,
+        path: requestPath,
+        agent,
+        headers: payload
+          ? { 'Content-Type': 'application/json', 'Content-Length': Buffer.byteLength(payload) }
+          : {},
+      },
+      res => {
+        res.resume();
+        res.on('end', () => resolve(res.statusCode || 0));
+      }
+    );
+    req.on('error', () => resolve(0));
+    req.end(payload);
+  });
+}
+
+async function startServer(dataDir: string): Promise<ChildProcess> {
+  if (!fs.existsSync(path.join(process.cwd(), '.next', 'BUILD_ID'))) {
+    throw new Error('No production build found; run `npm run build` first');
+  }
+
+  const server = spawn(path.join(process.cwd(), 'node_modules', '.bin', 'next'), ['start', '-p', String(port)], {
+    env: { ...process.env, NODE_ENV: 'production', POSTS_DATA_DIR: dataDir, RATE_LIMIT: 'off' },
+    stdio: ['ignore', 'ignore', 'inherit'],
+  });
+
+  let exited = false;
+  server.on('exit', () => {
+    exited = true;
+  });
+
+  const deadline = Date.now() + 60000;
+  while (Date.now() < deadline) {
+    if (exited) {
+      throw new Error('next start exited before it was ready');
+    }
+    if ((await send('GET', '/api/posts?limit=1')) === 200) {
+      return server;
+    }
+    await new Promise(resolve => setTimeout(resolve, 250));
+  }
+  server.kill();
+  throw new Error('next start did not answer within 60s');
+}
+
+// Open-loop generator: request n is due at start + n / rps
+function generate(seconds: number, samples: Sample[] | null, random: () => number): Promise<void> {
+  const pick = createPicker(SCENARIOS[scenarioName].mix, random);
+  const total = Math.round(seconds * rps);
+  const start = performance.now();
+  let issued = 0;
+  let finished = 0;
+  let inFlight = 0;
+
+  return new Promise(resolve => {
+    if (total === 0) {
+      resolve();
+      return;
+    }
+
+    const complete = () => {
+      if (++finished === total) {
+        resolve();
+      }
+    };
+
+    const issue = (n: number) => {
+      const op = pick();
+      const scheduled = start + (n * 1000) / rps;
+      const record = (ok: boolean) => {
+        if (samples) {
+          samples.push({ op, ms: performance.now() - scheduled, ok });
+        }
+        complete();
+      };
+
+      // Past the connection cap the server is not keeping up; count the
+      // request as failed rather than queueing it in the generator
+      if (inFlight >= maxInFlight) {
+        record(false);
+        return;
+      }
+
+      const request = buildRequest(op, postCount, random, n);
+      inFlight++;
+      send(request.method, request.path, request.body).then(status => {
+        inFlight--;
+        record(status >= 200 && status < 300);
+      });
+    };
+
+    const tick = () => {
+      const due = Math.min(total, Math.floor(((performance.now() - start) * rps) / 1000) + 1);
+      while (issued < due) {
+        issue(issued++);
+      }
+      if (issued < total) {
+        setTimeout(tick, 1);
+      }
+    };
+    tick();
+  });
+}
+
+function summarize(samples: Sample[], seconds: number): Summary {
+  const latencies = samples.map(sample => sample.ms).sort((a, b) => a - b);
+  const errors = samples.filter(sample => !sample.ok).length;
+  return {
+    requests: samples.length,
+    throughput: (samples.length - errors) / seconds,
+    errorRate: samples.length ? errors / samples.length : 0,
+    p50: percentile(latencies, 50),
+    p90: percentile(latencies, 90),
+    p99: percentile(latencies, 99),
+    max: latencies.length ? latencies[latencies.length - 1] : 0,
+  };
+}
+
+function printSummary(label: string, summary: Summary) {
+  console.log(
+    `${(label + '        ').slice(0, 8)} n=${summary.requests}  ${summary.throughput.toFixed(0)} ok/s  ` +
+      `errors=${(summary.errorRate * 100).toFixed(2)}%  p50=${summary.p50.toFixed(1)}ms  ` +
+      `p90=${summary.p90.toFixed(1)}ms  p99=${summary.p99.toFixed(1)}ms  max=${summary.max.toFixed(1)}ms`
+  );
+}
+
+// Regressions of `current` against `baseline`, as readable lines
+function regressions(current: Summary, baseline: BaselineEntry): string[] {
+  const found: string[] = [];
+  (['p50', 'p99'] as const).forEach(key => {
+    const limit = baseline[key] * (1 + tolerance) + LATENCY_SLACK_MS;
+    if (current[key] > limit) {
+      found.push(`${key} ${current[key].toFixed(1)}ms > ${limit.toFixed(1)}ms (baseline ${baseline[key].toFixed(1)}ms)`);
+    }
+  });
+  if (current.throughput < baseline.throughput * (1 - tolerance)) {
+    found.push(`throughput ${current.throughput.toFixed(0)}/s < baseline ${baseline.throughput.toFixed(0)}/s`);
+  }
+  if (current.errorRate > baseline.errorRate + 0.01) {
+    found.push(`error rate ${(current.errorRate * 100).toFixed(2)}% > baseline ${(baseline.errorRate * 100).toFixed(2)}%`);
+  }
+  return found;
+}
+
+function readBaseline(): Record<string, BaselineEntry> {
+  return fs.existsSync(baselineFile) ? JSON.parse(fs.readFileSync(baselineFile, 'utf8')) : {};
+}
+
+async function main() {
+  if (!SCENARIOS[scenarioName]) {
+    throw new Error(`Unknown scenario ${scenarioName}; pick one of ${Object.keys(SCENARIOS).join(', ')}`);
+  }
+
+  const dataDir = fs.mkdtempSync(path.join(os.tmpdir(), 'posts-load-'));
+  let server: ChildProcess | null = null;
+
+  try {
+    console.log(`Seeding ${postCount} posts into ${dataDir}...`);
+    await writeDatasetLog(dataDir, new DatasetGenerator({ seed, users: userCount, posts: postCount, comments: false }));
+    server = await startServer(dataDir);
+
+    console.log(`${scenarioName}: ${SCENARIOS[scenarioName].description}`);
+    console.log(`${rps} req/s for ${duration}s after ${warmup}s warm-up\n`);
+
+    const random = createRandom(seed);
+    await generate(warmup, null, random);
+    const samples: Sample[] = [];
+    await generate(duration, samples, random);
+
+    const overall = summarize(samples, duration);
+    (Object.keys(SCENARIOS[scenarioName].mix) as Operation[]).forEach(op => {
+      printSummary(op, summarize(samples.filter(sample => sample.op === op), duration));
+    });
+    printSummary('total', overall);
+
+    const baselines = readBaseline();
+    if (updateBaseline) {
+      baselines[scenarioName] = { ...overall, rps, posts: postCount, users: userCount };
+      fs.writeFileSync(baselineFile, JSON.stringify(baselines, null, 2) + '\n');
+      console.log(`\nBaseline for ${scenarioName} written to ${baselineFile}`);
+      return;
+    }
+
+    const baseline = baselines[scenarioName];
+    if (!baseline) {
+      console.log(`\nNo baseline for ${scenarioName} in ${baselineFile}; record one with --update-baseline`);
+      process.exitCode = 1;
+    } else if (baseline.rps !== rps || baseline.posts !== postCount || baseline.users !== userCount) {
+      console.log(`\nBaseline was recorded at ${baseline.rps} req/s over ${baseline.posts} posts by ${baseline.users} users; not comparable`);
+      process.exitCode = 1;
+    } else {
+      const found = regressions(overall, baseline);
+      if (found.length) {
+        console.log('\nRegressed against baseline:');
+        found.forEach(line => console.log(`  ${line}`));
+        process.exitCode = 1;
+      } else {
+        console.log('\nWithin baseline');
+      }
+    }
+  } finally {
+    agent.destroy();
+    if (server) {
+      server.kill();
+    }
+    fs.rmSync(dataDir, { recursive: true, force: true });
+  }
+}
+
+main().catch(error => {
+  console.error(error);
+  process.exit(1);
+});
@@ -0,0 +1,63 @@
+import listHandler from '@/pages/api/posts';
+import postHandler from '@/pages/api/posts/[id]';
+import { PostRepository, setPostRepository } from '@/server/postRepository';
+import { currentUser } from '@/utils/mockData';
+import { argNumber, createRequest, createResponse, expectOk, measure, measureAsync, seedPosts } from './harness';
+
+// Seeds N posts and measures per-request handler latency for the
+// single-post routes, which should stay flat as N grows.
+//
+//   npm run bench:api -- --posts=100000 --iterations=20000
+//
+// Writes are async (they wait for the write-ahead log), so they are timed
+// with measureAsync: one write in flight at a time, which also keeps them
+// clear of the rate limiter's load shedding. Every response must be 2xx.
+
+const postCount = argNumber('posts', 100000);
+const iterations = argNumber('iterations', 20000);
+
+async function main() {
+  console.log(`Seeding ${postCount} posts...`);
+  const seedStart = Date.now();
+  setPostRepository(new PostRepository(seedPosts(postCount, currentUser.id)));
+  console.log(`Seeded in ${Date.now() - seedStart}ms\n`);
+
+  const randomId = () => `seed-${Math.floor(Math.random() * postCount)}`;
+
+  measure('GET /api/posts/[id]', iterations, () => {
+    const res = createResponse();
+    postHandler(createRequest('GET', { id: randomId() }), res);
+    expectOk('GET /api/posts/[id]', res);
+  });
+
+  let cursor = '';
+  measure('GET /api/posts (next page)', iterations, () => {
+    const res = createResponse();
+    listHandler(createRequest('GET', cursor ? { limit: '20', cursor } : { limit: '20' }), res);
+    expectOk('GET /api/posts', res);
+    cursor = (res.body as { data: { nextCursor: string | null } }).data.nextCursor || '';
+  });
+
+  await measureAsync('PUT /api/posts/[id]', iterations, async () => {
+    const res = createResponse();
+    await postHandler(createRequest('PUT', { id: randomId() }, { title: 'Updated title' }), res);
+    expectOk('PUT /api/posts/[id]', res);
+  });
+
+  await measureAsync('POST /api/posts', iterations, async () => {
+    const res = createResponse();
+    await listHandler(createRequest('POST', {}, { title: 'New post', content: 'Benchmark content' }), res);
+    expectOk('POST /api/posts', res);
+  });
+
+  await measureAsync('DELETE /api/posts/[id]', iterations, async i => {
+    const res = createResponse();
+    await postHandler(createRequest('DELETE', { id: `seed-${i}` }), res);
+    expectOk('DELETE /api/posts/[id]', res);
+  });
+}
+
+main().catch(error => {
+  console.error(error);
+  process.exit(1);
+});
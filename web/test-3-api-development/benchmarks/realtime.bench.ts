@@ -0,0 +1,124 @@
+import http from 'http';
+import { AddressInfo } from 'net';
+import { performance } from 'perf_hooks';
+import WebSocket from 'ws';
+import { PostRepository } from '@/server/postRepository';
+import { FEED_TOPIC, REALTIME_PATH, RealtimeGateway, attachRealtime, postTopic } from '@/server/realtime';
+import { WebSocketMessage } from '@/types/websocket';
+import { argNumber, percentile, seedPosts } from './harness';
+
+// Realtime fan-out load test: --clients local WebSocket clients subscribe
+// to the feed (and half of them to one hot post), then --events likes hit
+// the hot post. Reports delivery latency, throughput and what the gateway
+// coalesced or dropped for the --slow percent of clients that stop reading.
+//
+//   npm run bench:realtime -- --clients=10000 --events=500 --slow=2
+//
+// Each client costs two file descriptors; raise the limit first
+// (`ulimit -n 65536`) for 10k clients.
+
+const clientCount = argNumber('clients', 10000);
+const eventCount = argNumber('events', 500);
+const slowPercent = argNumber('slow', 2);
+const connectConcurrency = argNumber('concurrency', 500);
+
+async function main() {
+  const repository = new PostRepository(seedPosts(100));
+  const hotPost = repository.list()[0];
+  const gateway = new RealtimeGateway();
+  gateway.watch(repository);
+
+  const server = http.createServer();
+  attachRealtime(server, gateway);
+  await new Promise<void>(resolve => server.listen(0, '127.0.0.1', resolve));
+  const { port } = server.address() as AddressInfo;
+  const url = `ws://127.0.0.1:${port}${REALTIME_PATH}`;
+
+  // 1. Connect
+  const clients: WebSocket[] = [];
+  const latencies: number[] = [];
+  let received = 0;
+  let connectStart = performance.now();
+
+  const connect = (index: number) =>
+    new Promise<void>((resolve, reject) => {
+      const ws = new WebSocket(`${url}?userId=bench-${index}`, { perMessageDeflate: false });
+      const slow = index % 100 < slowPercent;
+
+      ws.on('open', () => {
+        const topics = index % 2 === 0 ? [FEED_TOPIC, postTopic(hotPost.id)] : [FEED_TOPIC];
+        ws.send(JSON.stringify({ type: 'SUBSCRIBE', topics }));
+        // A slow consumer: stop reading so its socket buffers fill up
+        if (slow) {
+          (ws as unknown as { _socket: { pause(): void } })._socket.pause();
+        }
+        resolve();
+      });
+      ws.on('message', data => {
+        const message: WebSocketMessage = JSON.parse(data.toString());
+        if (message.type === 'POST_LIKED') {
+          received++;
+          latencies.push(Date.now() - message.timestamp);
+        }
+      });
+      ws.on('error', reject);
+      clients.push(ws);
+    });
+
+  for (let i = 0; i < clientCount; i += connectConcurrency) {
+    const wave: Promise<void>[] = [];
+    for (let j = i; j < Math.min(clientCount, i + connectConcurrency); j++) {
+      wave.push(connect(j));
+    }
+    await Promise.all(wave);
+  }
+  // Let the SUBSCRIBE messages land
+  await new Promise(resolve => setTimeout(resolve, 500));
+  console.log(
+    `Connected ${clientCount} clients in ${(performance.now() - connectStart).toFixed(0)}ms ` +
+      `(${gateway.subscriberCount(FEED_TOPIC)} on feed, ` +
+      `${gateway.subscriberCount(postTopic(hotPost.id))} on the hot post)`
+  );
+
+  // 2. Burst of likes on the hot post
+  const fastClients = clientCount - Math.ceil((clientCount * slowPercent) / 100);
+  const expected = eventCount * fastClients;
+  connectStart = performance.now();
+
+  for (let i = 0; i < eventCount; i++) {
+    repository.setLike(hotPost.id, `liker-${i}`, true);
+    if (i % 50 === 49) {
+      await new Promise(resolve => setImmediate(resolve));
+    }
+  }
+
+  const deadline = Date.now() + 60000;
+  while (received < expected && Date.now() < deadline) {
+    await new Promise(resolve => setTimeout(resolve, 20));
+  }
+  const elapsed = performance.now() - connectStart;
+
+  latencies.sort((a, b) => a - b);
+  console.log(
+    `Delivered ${received}/${expected} messages to reading clients in ${elapsed.toFixed(0)}ms ` +
+      `(${Math.round(received / (elapsed / 1000))}/s)`
+  );
+  console.log(
+    `Latency p50=${percentile(latencies, 50)}ms p99=${percentile(latencies, 99)}ms ` +
+      `max=${latencies[latencies.length - 1]}ms`
+  );
+  console.log(
+    `Gateway: published=${gateway.stats.published} delivered=${gateway.stats.delivered} ` +
+      `coalesced=${gateway.stats.coalesced} dropped=${gateway.stats.dropped}`
+  );
+  console.log(`Heap used: ${(process.memoryUsage().heapUsed / 1024 / 1024).toFixed(0)} MB`);
+
+  clients.forEach(ws => ws.terminate());
+  gateway.close();
+  server.close();
+}
+
+main().catch(error => {
+  console.error(error);
+  process.exit(1);
+});
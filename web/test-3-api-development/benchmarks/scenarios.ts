@@ -0,0 +1,75 @@
+import { postId } from '@/utils/dataset';
+
+// Request mixes for the load test (benchmarks/load.bench.ts). Each scenario
+// weights the operations below; the load generator picks one per request.
+
+export type Operation = 'read' | 'page' | 'write' | 'like';
+
+export interface Scenario {
+  description: string;
+  mix: Partial<Record<Operation, number>>; // Relative weights
+}
+
+export const SCENARIOS: Record<string, Scenario> = {
+  feed: {
+    description: 'Mostly reads: feed pages and single posts, a few writes and likes',
+    mix: { page: 50, read: 40, write: 5, like: 5 },
+  },
+  writes: {
+    description: 'Write-heavy: half the requests create posts',
+    mix: { page: 20, read: 20, write: 50, like: 10 },
+  },
+  likes: {
+    description: 'Like storm on a few hot posts while the feed is read',
+    mix: { page: 20, like: 80 },
+  },
+};
+
+export interface LoadRequest {
+  method: string;
+  path: string;
+  body?: unknown;
+}
+
+// Picks operations by weight; `random` returns [0, 1)
+export function createPicker(mix: Scenario['mix'], random: () => number): () => Operation {
+  const operations = Object.keys(mix) as Operation[];
+  const total = operations.reduce((sum, op) => sum + (mix[op] || 0), 0);
+
+  return () => {
+    let roll = random() * total;
+    for (let i = 0; i < operations.length; i++) {
+      roll -= mix[operations[i]] || 0;
+      if (roll < 0) {
+        return operations[i];
+      }
+    }
+    return operations[operations.length - 1];
+  };
+}
+
+// The request for one operation against `postCount` generated posts (ids
+// post-0 .. post-<postCount - 1>, see utils/dataset.ts)
+export function buildRequest(op: Operation, postCount: number, random: () => number, n: number): LoadRequest {
+  switch (op) {
+    case 'read':
+      return { method: 'GET', path: `/api/posts/${postId(Math.floor(random() * postCount))}` };
+    case 'page':
+      return { method: 'GET', path: '/api/posts?limit=20' };
+    case 'write':
+      return {
+        method: 'POST',
+        path: '/api/posts',
+        body: { title: `Load test post ${n}`, content: `Created by the load generator (request ${n})` },
+      };
+    case 'like': {
+      // Skewed towards the first posts, like real engagement
+      const hot = Math.floor(Math.pow(random(), 3) * postCount);
+      return {
+        method: 'POST',
+        path: `/api/posts/${postId(hot)}/like`,
+        body: { userId: `load-${n}`, liked: true },
+      };
+    }
+  }
+}
@@ -0,0 +1,38 @@
+import { PostRepository } from '@/server/postRepository';
+import { Post } from '@/types';
+import { argNumber, measure, seedPosts } from './harness';
+
+// Compares the repository's inverted index with the substring scan the feed
+// page does on the client (title/content/author name `includes`).
+//
+//   npm run bench:search -- --posts=100000 --iterations=2000
+
+const postCount = argNumber('posts', 100000);
+const iterations = argNumber('iterations', 2000);
+const queries = ['react', 'perf', 'typescript hooks', 'cloud secu', 'store memory async', '12345'];
+
+const posts = seedPosts(postCount);
+console.log(`Indexing ${postCount} posts...`);
+const indexStart = Date.now();
+const repository = new PostRepository(posts);
+console.log(`Indexed in ${Date.now() - indexStart}ms\n`);
+
+const substringScan = (query: string): Post[] => {
+  const searchLower = query.toLowerCase();
+  return posts.filter(
+    post =>
+      post.title.toLowerCase().includes(searchLower) ||
+      post.content.toLowerCase().includes(searchLower) ||
+      post.author.name.toLowerCase().includes(searchLower)
+  );
+};
+
+queries.forEach(query => {
+  console.log(`"${query}"`);
+  measure('  inverted index (first page)', iterations, () => {
+    repository.page({ search: query, limit: 20 });
+  });
+  measure('  substring scan', Math.max(1, Math.floor(iterations / 20)), () => {
+    substringScan(query);
+  });
+});
@@ -0,0 +1,64 @@
+import { performance } from 'perf_hooks';
+import { checkCreatePost, validatePost } from '@/utils/validation';
+import { argNumber, seedPosts } from './harness';
+
+// Throughput of the compiled create-post validator (utils/schema.ts) against
+// validatePost, over a mix of valid and invalid bodies. Validations are
+// timed in batches because a single one is well below timer resolution.
+//
+//   npm run bench:validation -- --validations=100000 --rounds=5
+
+const validations = argNumber('validations', 100000);
+const rounds = argNumber('rounds', 5);
+
+// One invalid body in ten: missing, blank, oversized and malformed fields
+const bodies: { title?: string; content?: string; imageUrl?: string }[] = seedPosts(1000).map((post, i) => {
+  const body = {
+    title: post.title,
+    content: post.content,
+    imageUrl: i % 3 === 0 ? `https://cdn.example.com/images/${post.id}.jpg` : undefined,
+  };
+  switch (i % 40) {
+    case 0:
+      return { content: body.content };
+    case 10:
+      return { ...body, title: '   ' };
+    case 20:
+      return { ...body, content: 'x'.repeat(5001) };
+    case 30:
+      return { ...body, imageUrl: 'not an image' };
+    default:
+      return body;
+  }
+});
+
+function throughput(label: string, validate: (body: typeof bodies[number]) => boolean) {
+  let invalid = 0;
+  const rates: number[] = [];
+
+  for (let round = 0; round < rounds; round++) {
+    invalid = 0;
+    const start = performance.now();
+    for (let i = 0; i < validations; i++) {
+      if (!validate(bodies[i % bodies.length])) {
+        invalid++;
+      }
+    }
+    rates.push(validations / ((performance.now() - start) / 1000));
+  }
+
+  // The first round includes JIT warm-up; report the best of the rest
+  const best = Math.max(...(rates.length > 1 ? rates.slice(1) : rates));
+  console.log(`${label}  ${Math.round(best).toLocaleString('en-US')} validations/s  (${invalid} invalid)`);
+  return best;
+}
+
+console.log(`${validations} validations x ${rounds} rounds\n`);
+const baseline = throughput('validatePost    ', body => validatePost(body).isValid);
+const compiled = throughput('checkCreatePost ', body => checkCreatePost(body) === null);
+
+console.log(`\n${(compiled / baseline).toFixed(1)}x validatePost`);
+if (compiled < 100000) {
+  console.log('Below the 100k validations/s budget');
+  process.exitCode = 1;
+}
@@ -0,0 +1,83 @@
+import fs from 'fs';
+import os from 'os';
+import path from 'path';
+import { performance } from 'perf_hooks';
+import { PostOperation, PostRepository } from '@/server/postRepository';
+import { attachPersistence } from '@/server/persistence';
+import { WriteAheadLog } from '@/server/writeAheadLog';
+import { argNumber, percentile, seedPosts } from './harness';
+
+// Write-ahead log benchmark:
+//   1. writes --ops operations (posts + likes) straight to a log
+//   2. measures how long a restart takes to replay them
+//   3. measures acknowledged write latency with --writers concurrent clients
+//
+//   npm run bench:wal -- --ops=1000000 --writers=64
+
+const opCount = argNumber('ops', 1000000);
+const writers = argNumber('writers', 64);
+const postCount = Math.max(1, Math.floor(opCount / 10));
+
+async function main() {
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'posts-wal-'));
+  console.log(`Log directory: ${dir}`);
+
+  // 1. Fill the log
+  const wal = new WriteAheadLog<PostOperation>(dir);
+  wal.load(() => undefined, () => undefined);
+  await wal.open();
+
+  const posts = seedPosts(postCount);
+  let writeStart = performance.now();
+  for (let i = 0; i < opCount; i++) {
+    if (i < postCount) {
+      wal.append({ op: 'insert', post: posts[i] });
+    } else {
+      wal.append({ op: 'like', id: posts[i % postCount].id, userId: `user-${i}`, liked: true });
+    }
+    if (i % 10000 === 0) {
+      await wal.sync();
+    }
+  }
+  await wal.close();
+  console.log(`Wrote ${opCount} operations in ${(performance.now() - writeStart).toFixed(0)}ms`);
+
+  // 2. Replay
+  const repository = new PostRepository();
+  const replayStart = performance.now();
+  attachPersistence(repository, dir);
+  console.log(
+    `Replayed into ${repository.size} posts in ${(performance.now() - replayStart).toFixed(0)}ms`
+  );
+
+  // 3. Group commit latency: every write waits for its fdatasync
+  const samples: number[] = [];
+  const perWriter = 200;
+  writeStart = performance.now();
+
+  await Promise.all(
+    Array.from({ length: writers }, async (_, writer) => {
+      for (let i = 0; i < perWriter; i++) {
+        const start = performance.now();
+        repository.setLike(posts[(writer * perWriter + i) % postCount].id, `bench-${writer}-${i}`, true);
+        await repository.sync();
+        samples.push((performance.now() - start) * 1000);
+      }
+    })
+  );
+
+  samples.sort((a, b) => a - b);
+  const elapsed = performance.now() - writeStart;
+  console.log(
+    `Durable writes: ${samples.length} from ${writers} writers in ${elapsed.toFixed(0)}ms ` +
+      `(${Math.round(samples.length / (elapsed / 1000))}/s)  ` +
+      `p50=${percentile(samples, 50).toFixed(0)}µs  p99=${percentile(samples, 99).toFixed(0)}µs`
+  );
+
+  fs.rmSync(dir, { recursive: true, force: true });
+}
+
+main().catch(error => {
+  console.error(error);
+  process.exit(1);
+});
@@ -1,3 +1,4 @@
+import { memo } from 'react';
 import {
   Box,
   Card,
@@ -8,7 +9,6 @@ import {
   HStack,
   VStack,
   Button,
-  Image,
   Flex,
   Spacer,
   IconButton,
@@ -16,6 +16,7 @@ import {
 } from '@chakra-ui/react';
 import { FiHeart, FiEdit, FiTrash2 } from 'react-icons/fi';
 import { PostCardProps } from '@/types';
+import PostImage from './PostImage';
 import { useUserStore } from '@/store/users';
 import { usePostsStore } from '@/store/posts';
 
@@ -29,10 +30,10 @@ import { usePostsStore } from '@/store/posts';
 
 const PostCard = ({ post, onEdit, onDelete }: PostCardProps) => {
   const toast = useToast();
-  const { currentUser } = useUserStore();
-  const { likePost } = usePostsStore();
+  // Narrow selectors: cards must not re-render when other posts change
+  const currentUser = useUserStore(state => state.currentUser);
+  const likePost = usePostsStore(state => state.likePost);
 
-  // BUG: This function has issues
   const handleLike = async () => {
     if (!currentUser) {
       toast({
@@ -43,9 +44,16 @@ const PostCard = ({ post, onEdit, onDelete }: PostCardProps) => {
       return;
     }
 
-    // TODO: Implement proper like functionality
-    // Should call likePost from store and handle errors
-    console.log('Like functionality not implemented');
+    // Toggles optimistically; the write goes through the outbox
+    try {
+      await likePost(post.id, currentUser.id);
+    } catch (error) {
+      toast({
+        title: 'Could not update like',
+        status: 'error',
+        duration: 3000,
+      });
+    }
   };
 
   const handleEdit = () => {
@@ -64,9 +72,10 @@ const PostCard = ({ post, onEdit, onDelete }: PostCardProps) => {
   const isLiked = post.likedBy.includes(currentUser.id);
   const isAuthor = post.authorId === currentUser.id;
 
-  // Format date - this could be improved
+  // Fixed locale and time zone: the server-rendered date must match the
+  // one the browser renders while hydrating
   const formatDate = (dateString: string) => {
-    return new Date(dateString).toLocaleDateString();
+    return new Date(dateString).toLocaleDateString('en-US', { timeZone: 'UTC' });
   };
 
   return (
@@ -128,13 +137,10 @@ const PostCard = ({ post, onEdit, onDelete }: PostCardProps) => {
 
           {/* Post Image */}
           {post.imageUrl && (
-            <Image
+            <PostImage
               src={post.imageUrl}
               alt={post.title}
-              borderRadius="md"
-              maxH="300px"
-              objectFit="cover"
-              w="full"
+              placeholder={post.imagePlaceholder}
             />
           )}
 
@@ -158,4 +164,5 @@ const PostCard = ({ post, onEdit, onDelete }: PostCardProps) => {
   );
 };
 
-export default PostCard;
+// Memoized so rows the feed window keeps mounted skip re-rendering on scroll
+export default memo(PostCard);
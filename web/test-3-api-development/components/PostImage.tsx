@@ -0,0 +1,77 @@
+import { memo, useEffect, useRef, useState } from 'react';
+import { Box } from '@chakra-ui/react';
+import { FEED_IMAGE_SIZES, buildSrcSet, imageVariant, whenNearViewport } from '@/utils/images';
+
+interface PostImageProps {
+  src: string;
+  alt: string;
+  placeholder?: string;
+  height?: string;
+}
+
+// Fallback width for browsers without srcset support
+const FALLBACK_WIDTH = 640;
+
+// Post image with a fixed-height slot (no layout shift), the blurred
+// placeholder painted inline, and the real image requested only once the
+// slot is within the prefetch margin, at the width the layout needs.
+const PostImage = ({ src, alt, placeholder, height = '300px' }: PostImageProps) => {
+  const slot = useRef<HTMLDivElement>(null);
+  const [near, setNear] = useState(false);
+  const [loaded, setLoaded] = useState(false);
+
+  useEffect(() => {
+    setLoaded(false);
+    if (!slot.current) {
+      return;
+    }
+    return whenNearViewport(slot.current, () => setNear(true));
+  }, [src]);
+
+  return (
+    <Box
+      ref={slot}
+      position="relative"
+      h={height}
+      overflow="hidden"
+      borderRadius="md"
+      bg="gray.100"
+    >
+      {placeholder && !loaded && (
+        <Box
+          as="img"
+          src={placeholder}
+          alt=""
+          aria-hidden="true"
+          position="absolute"
+          inset={0}
+          w="full"
+          h="full"
+          objectFit="cover"
+          filter="blur(20px)"
+          transform="scale(1.1)"
+        />
+      )}
+      {near && (
+        <Box
+          as="img"
+          src={imageVariant(src, FALLBACK_WIDTH)}
+          srcSet={buildSrcSet(src)}
+          sizes={FEED_IMAGE_SIZES}
+          alt={alt}
+          loading="lazy"
+          decoding="async"
+          onLoad={() => setLoaded(true)}
+          position="relative"
+          w="full"
+          h="full"
+          objectFit="cover"
+          opacity={loaded ? 1 : 0}
+          transition="opacity 0.2s"
+        />
+      )}
+    </Box>
+  );
+};
+
+export default memo(PostImage);
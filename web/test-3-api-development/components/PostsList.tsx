@@ -1,34 +1,61 @@
+import { memo, useCallback } from 'react';
 import { Box, Text, Spinner, Center, VStack } from '@chakra-ui/react';
 import PostCard from './PostCard';
 import { Post } from '@/types';
-import { usePostsStore } from '@/store/posts';
+import { usePost, usePostsStore } from '@/store/posts';
+import { useWindowedList } from '@/utils/windowing';
 
 interface PostsListProps {
   posts: Post[];
 }
 
-// TODO: Fix performance issues in this component
-// Issues:
-// 1. No memoization - re-renders unnecessarily
-// 2. Inefficient rendering of large lists
-// 3. No virtualization for long lists
-// 4. Missing loading and error states
+// Height guesses for rows that have not been measured yet (card + margin).
+// Image posts are much taller; measured heights replace these on mount.
+const ESTIMATED_TEXT_ROW_HEIGHT = 260;
+const ESTIMATED_IMAGE_ROW_HEIGHT = 580;
 
+const getPostKey = (post: Post) => post.id;
+const estimatePostHeight = (post: Post) =>
+  post.imageUrl ? ESTIMATED_IMAGE_ROW_HEIGHT : ESTIMATED_TEXT_ROW_HEIGHT;
+
+interface PostsListRowProps {
+  id: string;
+  onEdit: (post: Post) => void;
+  onDelete: (postId: string) => void;
+}
+
+// Each row subscribes to its own post, so a like or edit re-renders one card
+const PostsListRow = memo(({ id, onEdit, onDelete }: PostsListRowProps) => {
+  const post = usePost(id);
+  return post ? <PostCard post={post} onEdit={onEdit} onDelete={onDelete} /> : null;
+});
+PostsListRow.displayName = 'PostsListRow';
+
+// Only the posts around the viewport are mounted (see utils/windowing.ts),
+// so the DOM stays the same size however long the feed is.
 const PostsList = ({ posts }: PostsListProps) => {
-  const { loading, error, deletePost } = usePostsStore();
+  const loading = usePostsStore(state => state.loading);
+  const error = usePostsStore(state => state.error);
+  const deletePost = usePostsStore(state => state.deletePost);
+  const { containerRef, measureRef, start, end, paddingTop, paddingBottom } = useWindowedList({
+    items: posts,
+    getKey: getPostKey,
+    estimateHeight: estimatePostHeight,
+  });
 
-  // BUG: This function recreates on every render
-  const handleEdit = (post: Post) => {
+  const handleEdit = useCallback((post: Post) => {
     console.log('Edit post:', post.id);
     // TODO: Implement edit functionality
-  };
+  }, []);
 
-  // BUG: This function recreates on every render
-  const handleDelete = async (postId: string) => {
-    if (window.confirm('Are you sure you want to delete this post?')) {
-      await deletePost(postId);
-    }
-  };
+  const handleDelete = useCallback(
+    async (postId: string) => {
+      if (window.confirm('Are you sure you want to delete this post?')) {
+        await deletePost(postId);
+      }
+    },
+    [deletePost]
+  );
 
   if (loading) {
     return (
@@ -64,16 +91,19 @@ const PostsList = ({ posts }: PostsListProps) => {
     );
   }
 
+  // Spacers stand in for the unmounted rows above and below the window.
+  // Browser scroll anchoring is off: the hook does its own on prepend.
   return (
-    <Box>
-      {/* TODO: Add virtualization for better performance with large lists */}
-      {posts.map((post) => (
-        <PostCard
-          key={post.id}
-          post={post}
-          onEdit={handleEdit}
-          onDelete={handleDelete}
-        />
+    <Box ref={containerRef} style={{ paddingTop, paddingBottom }} sx={{ overflowAnchor: 'none' }}>
+      {posts.slice(start, end).map((post) => (
+        // flow-root keeps the card's margin inside the measured row
+        <Box key={post.id} ref={measureRef(post.id)} display="flow-root">
+          <PostsListRow
+            id={post.id}
+            onEdit={handleEdit}
+            onDelete={handleDelete}
+          />
+        </Box>
       ))}
     </Box>
   );
@@ -0,0 +1,20 @@
+import type { NextApiRequest, NextApiResponse } from 'next';
+import { formatPrometheus, getApiMetrics } from '@/server/metrics';
+
+// GET /api/metrics
+// Latency histograms and quantiles, payload sizes and status counts for
+// every instrumented route (server/metrics.ts), in Prometheus text format.
+
+export default function handler(req: NextApiRequest, res: NextApiResponse) {
+  if (req.method !== 'GET') {
+    res.setHeader('Allow', ['GET']);
+    return res.status(405).json({
+      success: false,
+      error: `Method ${req.method} not allowed`,
+    });
+  }
+
+  res.setHeader('Content-Type', 'text/plain; version=0.0.4; charset=utf-8');
+  res.setHeader('Cache-Control', 'no-store');
+  return res.status(200).send(formatPrometheus(getApiMetrics()));
+}
@@ -1,13 +1,25 @@
 import type { NextApiRequest, NextApiResponse } from 'next';
 import { ApiResponse, Post, UpdatePostData } from '@/types';
-import { mockPosts } from '@/utils/mockData';
+import { currentUser } from '@/utils/mockData';
+import { getPostRepository, PostChanges } from '@/server/postRepository';
+import { createImagePlaceholder } from '@/server/imagePlaceholder';
+import { respondIfFresh, versionEtag } from '@/server/etag';
+import { withMetrics } from '@/server/metrics';
+import { withRateLimit } from '@/server/rateLimit';
+import { checkUpdatePost } from '@/utils/validation';
 
-// TODO: Implement individual post operations
-// This is a simplified in-memory implementation for testing
+// Individual post operations on the shared in-memory repository
 
-let posts = [...mockPosts];
+// See pages/api/posts/index.ts: oversized bodies are refused before parsing
+export const config = {
+  api: {
+    bodyParser: { sizeLimit: '64kb' },
+  },
+};
 
-export default function handler(
+export default withMetrics('/api/posts/[id]', withRateLimit(handler));
+
+function handler(
   req: NextApiRequest,
   res: NextApiResponse<ApiResponse<Post>>
 ) {
@@ -41,10 +53,8 @@ function handleGet(
   res: NextApiResponse<ApiResponse<Post>>,
   id: string
 ) {
-  // TODO: Implement GET /api/posts/[id]
-  // Should return a single post by ID
-  
-  const post = posts.find(p => p.id === id);
+  const repository = getPostRepository();
+  const post = repository.get(id);
   
   if (!post) {
     return res.status(404).json({
@@ -53,51 +63,118 @@ function handleGet(
     });
   }
 
+  if (respondIfFresh(req, res, versionEtag(repository.epoch, repository.versionOf(id)))) {
+    return;
+  }
+
   return res.status(200).json({
     success: true,
     data: post,
   });
 }
 
-function handlePut(
+async function handlePut(
   req: NextApiRequest,
   res: NextApiResponse<ApiResponse<Post>>,
   id: string
 ) {
-  // TODO: Implement PUT /api/posts/[id]
-  // Should update a post and return the updated post
-  // Requirements:
-  // 1. Find post by ID
-  // 2. Validate update data
-  // 3. Check if user is the author (authorization)
-  // 4. Update only provided fields
-  // 5. Update the updatedAt timestamp
-  
-  console.log('PUT /api/posts/[id] not implemented yet');
-  
-  return res.status(501).json({
-    success: false,
-    error: 'Update functionality not implemented yet',
-  });
+  try {
+    const repository = getPostRepository();
+    const post = repository.get(id);
+
+    if (!post) {
+      return res.status(404).json({
+        success: false,
+        error: 'Post not found',
+      });
+    }
+
+    if (post.authorId !== currentUser.id) {
+      return res.status(403).json({
+        success: false,
+        error: 'Only the author can update this post',
+      });
+    }
+
+    const errors = checkUpdatePost(req.body);
+    if (errors) {
+      return res.status(400).json({
+        success: false,
+        error: errors.join('; '),
+      });
+    }
+
+    // Update only the provided fields
+    const { title, content, imageUrl }: UpdatePostData = req.body;
+    const changes: PostChanges = {};
+
+    if (title !== undefined) changes.title = title;
+    if (content !== undefined) changes.content = content;
+    if (imageUrl !== undefined) changes.imageUrl = imageUrl;
+
+    // A new image gets a new blur placeholder
+    if (imageUrl !== undefined && imageUrl !== post.imageUrl) {
+      changes.imagePlaceholder = imageUrl ? await createImagePlaceholder(imageUrl) : undefined;
+    }
+
+    changes.updatedAt = new Date().toISOString();
+    const updated = repository.update(id, changes);
+    if (!updated) {
+      // Deleted while the placeholder was being fetched
+      return res.status(404).json({
+        success: false,
+        error: 'Post not found',
+      });
+    }
+    await repository.sync();
+
+    return res.status(200).json({
+      success: true,
+      data: updated,
+      message: 'Post updated successfully',
+    });
+  } catch (error) {
+    return res.status(500).json({
+      success: false,
+      error: 'Failed to update post',
+    });
+  }
 }
 
-function handleDelete(
+async function handleDelete(
   req: NextApiRequest,
   res: NextApiResponse<ApiResponse<Post>>,
   id: string
 ) {
-  // TODO: Implement DELETE /api/posts/[id]
-  // Should delete a post
-  // Requirements:
-  // 1. Find post by ID
-  // 2. Check if user is the author (authorization)
-  // 3. Remove post from array
-  // 4. Return success message
-  
-  console.log('DELETE /api/posts/[id] not implemented yet');
-  
-  return res.status(501).json({
-    success: false,
-    error: 'Delete functionality not implemented yet',
-  });
+  try {
+    const repository = getPostRepository();
+    const post = repository.get(id);
+
+    if (!post) {
+      return res.status(404).json({
+        success: false,
+        error: 'Post not found',
+      });
+    }
+
+    if (post.authorId !== currentUser.id) {
+      return res.status(403).json({
+        success: false,
+        error: 'Only the author can delete this post',
+      });
+    }
+
+    repository.remove(id);
+    await repository.sync();
+
+    return res.status(200).json({
+      success: true,
+      message: 'Post deleted successfully',
+    });
+  } catch (error) {
+    return res.status(500).json({
+      success: false,
+      error: 'Failed to delete post',
+    });
+  }
 }
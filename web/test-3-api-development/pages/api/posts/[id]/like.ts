@@ -0,0 +1,104 @@
+import type { NextApiRequest, NextApiResponse } from 'next';
+import { ApiResponse, LikeState } from '@/types';
+import { currentUser } from '@/utils/mockData';
+import { getPostRepository } from '@/server/postRepository';
+import { ifMatchFails, versionEtag } from '@/server/etag';
+import { withMetrics } from '@/server/metrics';
+import { withRateLimit } from '@/server/rateLimit';
+
+// POST /api/posts/[id]/like
+// Body: { liked?: boolean, userId?: string }
+//
+// Sets the like state for a user (toggles when `liked` is omitted) and
+// answers { likes, liked, version } rather than the whole post, whose likedBy
+// grows with every liker. The update is applied atomically by the
+// repository, so parallel likes never lose updates. Clients that need
+// compare-and-swap send the post's ETag in If-Match and get 412 if the post
+// changed since they read it.
+
+export default withMetrics('/api/posts/[id]/like', withRateLimit(handler));
+
+async function handler(
+  req: NextApiRequest,
+  res: NextApiResponse<ApiResponse<LikeState>>
+) {
+  const { id } = req.query;
+
+  if (typeof id !== 'string') {
+    return res.status(400).json({
+      success: false,
+      error: 'Invalid post ID',
+    });
+  }
+
+  if (req.method !== 'POST') {
+    res.setHeader('Allow', ['POST']);
+    return res.status(405).json({
+      success: false,
+      error: `Method ${req.method} not allowed`,
+    });
+  }
+
+  try {
+    const repository = getPostRepository();
+
+    if (!repository.has(id)) {
+      return res.status(404).json({
+        success: false,
+        error: 'Post not found',
+      });
+    }
+
+    if (ifMatchFails(req, versionEtag(repository.epoch, repository.versionOf(id)))) {
+      res.setHeader('ETag', versionEtag(repository.epoch, repository.versionOf(id)));
+      return res.status(412).json({
+        success: false,
+        error: 'Post was modified; refetch and retry',
+      });
+    }
+
+    // There is no auth yet, so the user comes from the body (mock current user by default)
+    const { liked, userId = currentUser.id } = req.body || {};
+
+    if (liked !== undefined && typeof liked !== 'boolean') {
+      return res.status(400).json({
+        success: false,
+        error: 'liked must be a boolean',
+      });
+    }
+
+    if (typeof userId !== 'string' || userId.length === 0) {
+      return res.status(400).json({
+        success: false,
+        error: 'Invalid user ID',
+      });
+    }
+
+    const result = repository.setLike(id, userId, liked);
+    if (!result) {
+      return res.status(404).json({
+        success: false,
+        error: 'Post not found',
+      });
+    }
+
+    // The version is read before awaiting so the ETag matches this write
+    const version = repository.versionOf(id);
+    const etag = versionEtag(repository.epoch, version);
+    if (result.changed) {
+      await repository.sync();
+    }
+
+    res.setHeader('ETag', etag);
+    return res.status(200).json({
+      success: true,
+      data: { likes: result.likes, liked: result.liked, version },
+      message: result.liked ? 'Post liked' : 'Post unliked',
+    });
+  } catch (error) {
+    return res.status(500).json({
+      success: false,
+      error: 'Failed to update like',
+    });
+  }
+}
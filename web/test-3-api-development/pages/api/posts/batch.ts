@@ -0,0 +1,60 @@
+import type { NextApiRequest, NextApiResponse } from 'next';
+import { ApiResponse, Post, PostBatch } from '@/types';
+import { getPostRepository } from '@/server/postRepository';
+import { withMetrics } from '@/server/metrics';
+import { withRateLimit } from '@/server/rateLimit';
+
+// Fetch many posts in one round trip: POST { ids: string[] }
+// The client coalesces getById calls made in the same tick into one of these
+// (see utils/api.ts). Ids that do not exist are reported in `missing`.
+
+const MAX_BATCH_SIZE = 100;
+
+export default withMetrics('/api/posts/batch', withRateLimit(handler, { readOnly: true }));
+
+function handler(
+  req: NextApiRequest,
+  res: NextApiResponse<ApiResponse<PostBatch>>
+) {
+  if (req.method !== 'POST') {
+    res.setHeader('Allow', ['POST']);
+    return res.status(405).json({
+      success: false,
+      error: `Method ${req.method} not allowed`,
+    });
+  }
+
+  const ids = req.body && req.body.ids;
+
+  if (!Array.isArray(ids) || ids.some(id => typeof id !== 'string')) {
+    return res.status(400).json({
+      success: false,
+      error: 'ids must be an array of post IDs',
+    });
+  }
+
+  if (ids.length > MAX_BATCH_SIZE) {
+    return res.status(400).json({
+      success: false,
+      error: `At most ${MAX_BATCH_SIZE} ids per batch`,
+    });
+  }
+
+  const repository = getPostRepository();
+  const posts: Post[] = [];
+  const missing: string[] = [];
+
+  ids.forEach((id: string) => {
+    const post = repository.get(id);
+    if (post) {
+      posts.push(post);
+    } else {
+      missing.push(id);
+    }
+  });
+
+  return res.status(200).json({
+    success: true,
+    data: { posts, missing },
+  });
+}
@@ -0,0 +1,73 @@
+import type { NextApiRequest, NextApiResponse } from 'next';
+import { ApiResponse, PostChangeSet } from '@/types';
+import { getPostRepository } from '@/server/postRepository';
+import { rangeEtag, respondIfFresh } from '@/server/etag';
+import { withMetrics } from '@/server/metrics';
+import { withRateLimit } from '@/server/rateLimit';
+
+// GET /api/posts/changes?since=<version>&epoch=<epoch>
+// Delta sync for polling clients: returns only the posts created, updated
+// and deleted after `since`. A repeated poll whose page has not changed is a
+// bodyless 304.
+
+const DEFAULT_CHANGES_LIMIT = 500;
+const MAX_CHANGES_LIMIT = 1000;
+
+export default withMetrics('/api/posts/changes', withRateLimit(handler));
+
+function handler(
+  req: NextApiRequest,
+  res: NextApiResponse<ApiResponse<PostChangeSet>>
+) {
+  if (req.method !== 'GET') {
+    res.setHeader('Allow', ['GET']);
+    return res.status(405).json({
+      success: false,
+      error: `Method ${req.method} not allowed`,
+    });
+  }
+
+  try {
+    const { since: rawSince, epoch, limit: rawLimit } = req.query;
+    const since = Number(rawSince);
+    const limit = rawLimit === undefined ? DEFAULT_CHANGES_LIMIT : Number(rawLimit);
+
+    if (!Number.isInteger(since) || since < 0) {
+      return res.status(400).json({
+        success: false,
+        error: 'since must be a non-negative integer version',
+      });
+    }
+
+    if (!Number.isInteger(limit) || limit < 1 || limit > MAX_CHANGES_LIMIT) {
+      return res.status(400).json({
+        success: false,
+        error: `limit must be an integer between 1 and ${MAX_CHANGES_LIMIT}`,
+      });
+    }
+
+    const repository = getPostRepository();
+    const sameRun = epoch === undefined || epoch === repository.epoch;
+
+    const changes = sameRun
+      ? repository.changesSince(since, limit)
+      : { ...repository.changesSince(repository.version, limit), reset: true };
+
+    // A page holds exactly the changes in (since, changes.version]: any later
+    // write to one of its posts moves that post past the page and changes
+    // the range. So the range validates partial (hasMore) pages too.
+    if (!changes.reset && respondIfFresh(req, res, rangeEtag(changes.epoch, since, changes.version))) {
+      return;
+    }
+
+    return res.status(200).json({
+      success: true,
+      data: changes,
+    });
+  } catch (error) {
+    return res.status(500).json({
+      success: false,
+      error: 'Failed to fetch changes',
+    });
+  }
+}
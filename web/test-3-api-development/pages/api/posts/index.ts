@@ -1,16 +1,36 @@
 import type { NextApiRequest, NextApiResponse } from 'next';
-import { ApiResponse, Post, CreatePostData } from '@/types';
-import { mockPosts, generateId, currentUser } from '@/utils/mockData';
+import { ApiResponse, Post, CreatePostData, PaginatedResponse, PostFilters } from '@/types';
+import { generateId, currentUser } from '@/utils/mockData';
+import { createImagePlaceholder } from '@/server/imagePlaceholder';
+import { getPostRepository, PostKey } from '@/server/postRepository';
+import { decodeCursor, encodeCursor } from '@/server/cursor';
+import { respondIfFresh, versionEtag } from '@/server/etag';
+import { writeChunk } from '@/server/stream';
+import { withMetrics } from '@/server/metrics';
+import { withRateLimit } from '@/server/rateLimit';
+import { checkCreatePost } from '@/utils/validation';
 
-// TODO: Implement proper API endpoints
-// This is a simplified in-memory implementation for testing
+// Posts are kept in the shared in-memory repository (server/postRepository.ts)
 // In a real app, this would connect to a database
 
-let posts = [...mockPosts];
+const DEFAULT_PAGE_SIZE = 20;
+const MAX_PAGE_SIZE = 100;
+// Posts read from the repository per step while streaming an export
+const STREAM_BATCH_SIZE = 256;
 
-export default function handler(
+// Bodies larger than the biggest valid post (5000 characters of content,
+// escaped) are refused with 413 before they are read into memory and parsed
+export const config = {
+  api: {
+    bodyParser: { sizeLimit: '64kb' },
+  },
+};
+
+export default withMetrics('/api/posts', withRateLimit(handler));
+
+function handler(
   req: NextApiRequest,
-  res: NextApiResponse<ApiResponse<Post | Post[]>>
+  res: NextApiResponse<ApiResponse<Post | PaginatedResponse<Post>>>
 ) {
   switch (req.method) {
     case 'GET':
@@ -28,21 +48,79 @@ export default function handler(
 
 function handleGet(
   req: NextApiRequest,
-  res: NextApiResponse<ApiResponse<Post[]>>
+  res: NextApiResponse<ApiResponse<PaginatedResponse<Post>>>
 ) {
   try {
-    // TODO: Add query parameters for filtering and pagination
-    // - search: string
-    // - authorId: string
-    // - limit: number
-    // - offset: number
-    // - sortBy: 'date' | 'popularity'
-    // - sortOrder: 'asc' | 'desc'
-
-    // For now, just return all posts
+    // Keyset pagination: ?sortBy=&sortOrder=&authorId=&search=&limit=&cursor=
+    // Each page costs O(log n + limit) no matter how deep the cursor is;
+    // search uses the repository's inverted index instead of scanning posts.
+    const sortBy = queryParam(req, 'sortBy') || 'date';
+    const sortOrder = queryParam(req, 'sortOrder') || 'desc';
+    const authorId = queryParam(req, 'authorId');
+    const search = queryParam(req, 'search');
+    const rawLimit = queryParam(req, 'limit');
+    const rawCursor = queryParam(req, 'cursor');
+
+    if (sortBy !== 'date' && sortBy !== 'popularity') {
+      return res.status(400).json({
+        success: false,
+        error: "sortBy must be 'date' or 'popularity'",
+      });
+    }
+
+    if (sortOrder !== 'asc' && sortOrder !== 'desc') {
+      return res.status(400).json({
+        success: false,
+        error: "sortOrder must be 'asc' or 'desc'",
+      });
+    }
+
+    const limit = rawLimit === undefined ? DEFAULT_PAGE_SIZE : Number(rawLimit);
+    if (!Number.isInteger(limit) || limit < 1 || limit > MAX_PAGE_SIZE) {
+      return res.status(400).json({
+        success: false,
+        error: `limit must be an integer between 1 and ${MAX_PAGE_SIZE}`,
+      });
+    }
+
+    let after: PostKey | undefined;
+    if (rawCursor) {
+      const decoded = decodeCursor(sortBy, rawCursor);
+      if (!decoded) {
+        return res.status(400).json({
+          success: false,
+          error: 'Invalid cursor',
+        });
+      }
+      after = decoded;
+    }
+
+    // Any write bumps the store version, so an unchanged version means the
+    // client's copy of this URL is still current
+    const repository = getPostRepository();
+    res.setHeader('Vary', 'Accept');
+    if (respondIfFresh(req, res, versionEtag(repository.epoch, repository.version))) {
+      return;
+    }
+
+    const filters: PostFilters = { sortBy, sortOrder, authorId, search };
+
+    if (wantsStream(req)) {
+      return streamPosts(res, { ...filters, after });
+    }
+
+    const { posts, total, hasMore } = repository.page({ ...filters, limit, after });
+    const last = posts[posts.length - 1];
+
     return res.status(200).json({
       success: true,
-      data: posts,
+      data: {
+        data: posts,
+        total,
+        limit,
+        hasMore,
+        nextCursor: hasMore && last ? encodeCursor(sortBy, repository.keyOf(last)) : null,
+      },
     });
   } catch (error) {
     return res.status(500).json({
@@ -52,34 +130,78 @@ function handleGet(
   }
 }
 
-function handlePost(
-  req: NextApiRequest,
-  res: NextApiResponse<ApiResponse<Post>>
+// NDJSON export of the whole listing: ?stream=1 or Accept: application/x-ndjson
+function wantsStream(req: NextApiRequest): boolean {
+  const accept = req.headers.accept || '';
+  return queryParam(req, 'stream') === '1' || accept.indexOf('application/x-ndjson') !== -1;
+}
+
+// Writes one post per line, reading the listing in keyset batches and
+// waiting for the socket to drain, so the first bytes go out immediately and
+// memory stays constant however large the export is. Later batches resume
+// from the last key, so concurrent writes never duplicate or skip survivors.
+async function streamPosts(
+  res: NextApiResponse,
+  options: PostFilters & { after?: PostKey }
 ) {
+  const repository = getPostRepository();
+  let after = options.after;
+
+  res.status(200);
+  res.setHeader('Content-Type', 'application/x-ndjson; charset=utf-8');
+  res.setHeader('X-Content-Type-Options', 'nosniff');
+
   try {
-    // TODO: Add proper validation
-    // 1. Validate required fields (title, content)
-    // 2. Sanitize input data
-    // 3. Check title length (max 200 chars)
-    // 4. Check content length (max 5000 chars)
-    // 5. Validate image URL format if provided
+    for (;;) {
+      const { posts, hasMore } = repository.page({ ...options, limit: STREAM_BATCH_SIZE, after });
 
-    const { title, content, imageUrl }: CreatePostData = req.body;
+      for (let i = 0; i < posts.length; i++) {
+        if (!(await writeChunk(res, JSON.stringify(posts[i]) + '\n'))) {
+          return;
+        }
+      }
 
-    // Basic validation (you should improve this)
-    if (!title || !content) {
+      if (!hasMore || posts.length === 0) {
+        break;
+      }
+      after = repository.keyOf(posts[posts.length - 1]);
+    }
+    res.end();
+  } catch (error) {
+    // Headers are already out, so the only way to signal failure is to
+    // abort the connection and let the client see a truncated stream
+    res.destroy(error instanceof Error ? error : undefined);
+  }
+}
+
+// Single string value of a query parameter (first one wins for repeats)
+function queryParam(req: NextApiRequest, name: string): string | undefined {
+  const value = req.query[name];
+  return Array.isArray(value) ? value[0] : value;
+}
+
+async function handlePost(
+  req: NextApiRequest,
+  res: NextApiResponse<ApiResponse<Post>>
+) {
+  try {
+    const errors = checkCreatePost(req.body);
+    if (errors) {
       return res.status(400).json({
         success: false,
-        error: 'Title and content are required',
+        error: errors.join('; '),
       });
     }
 
+    const { title, content, imageUrl }: CreatePostData = req.body;
+
     // Create new post
     const newPost: Post = {
       id: generateId(),
       title,
       content,
-      imageUrl,
+      imageUrl: imageUrl || undefined,
+      imagePlaceholder: imageUrl ? await createImagePlaceholder(imageUrl) : undefined,
       authorId: currentUser.id,
       author: currentUser,
       likes: 0,
@@ -88,8 +210,10 @@ function handlePost(
       updatedAt: new Date().toISOString(),
     };
 
-    // Add to posts array (in a real app, save to database)
-    posts.unshift(newPost);
+    // Add to the repository and wait for the write-ahead log to persist it
+    const repository = getPostRepository();
+    repository.insert(newPost);
+    await repository.sync();
 
     return res.status(201).json({
       success: true,
@@ -0,0 +1,199 @@
+import type { NextApiRequest, NextApiResponse } from 'next';
+import { ApiResponse, CreatePostData, MutationBatch, MutationResult, Post, PostMutation, UpdatePostData } from '@/types';
+import { currentUser } from '@/utils/mockData';
+import { getPostRepository, PostChanges, PostRepository } from '@/server/postRepository';
+import { getIdempotencyStore } from '@/server/idempotency';
+import { createImagePlaceholder } from '@/server/imagePlaceholder';
+import { withMetrics } from '@/server/metrics';
+import { withRateLimit } from '@/server/rateLimit';
+import { checkCreatePost, checkUpdatePost } from '@/utils/validation';
+
+// POST /api/posts/mutations  Body: { mutations: PostMutation[] }
+//
+// Applies queued writes from a client's offline outbox (utils/outbox.ts) in
+// order and answers with one result per mutation. Each mutation succeeds or
+// fails on its own, with the status the single-post endpoint would return.
+// Results are remembered by idempotency key (and persisted with the posts),
+// so replaying a batch whose response was lost, even across a restart,
+// returns the same results without applying anything twice. A replayed
+// success carries the post as it is now. The write-ahead log is synced once
+// for the whole batch.
+
+const MAX_MUTATIONS = 100;
+
+export default withMetrics('/api/posts/mutations', withRateLimit(handler));
+
+async function handler(
+  req: NextApiRequest,
+  res: NextApiResponse<ApiResponse<MutationBatch>>
+) {
+  if (req.method !== 'POST') {
+    res.setHeader('Allow', ['POST']);
+    return res.status(405).json({
+      success: false,
+      error: `Method ${req.method} not allowed`,
+    });
+  }
+
+  const mutations = req.body && req.body.mutations;
+
+  if (
+    !Array.isArray(mutations) ||
+    mutations.some(
+      (mutation: PostMutation) =>
+        !mutation || typeof mutation.key !== 'string' || !mutation.key || typeof mutation.postId !== 'string'
+    )
+  ) {
+    return res.status(400).json({
+      success: false,
+      error: 'mutations must be an array of { key, type, postId, ... }',
+    });
+  }
+
+  if (mutations.length > MAX_MUTATIONS) {
+    return res.status(400).json({
+      success: false,
+      error: `At most ${MAX_MUTATIONS} mutations per batch`,
+    });
+  }
+
+  try {
+    const repository = getPostRepository();
+    const applied = getIdempotencyStore<MutationResult>();
+    let logged = false;
+
+    // Fetched up front, so the batch itself is applied without yielding
+    const placeholders = new Map<string, string | undefined>();
+    await Promise.all(
+      mutations.map((mutation: PostMutation) => {
+        const imageUrl = (mutation.type === 'create' || mutation.type === 'update') && mutation.data
+          ? mutation.data.imageUrl
+          : undefined;
+        if (!imageUrl || placeholders.has(imageUrl) || applied.get(mutation.key)) {
+          return undefined;
+        }
+        placeholders.set(imageUrl, undefined);
+        return createImagePlaceholder(imageUrl).then(placeholder => {
+          placeholders.set(imageUrl, placeholder);
+        });
+      })
+    );
+
+    const results = mutations.map((mutation: PostMutation) => {
+      const previous = applied.get(mutation.key);
+      if (previous) {
+        const post = previous.status < 300 ? repository.get(mutation.postId) : undefined;
+        return { ...previous, post, replayed: true };
+      }
+      const result = applyMutation(repository, mutation, placeholders);
+      // Only final answers are remembered; a 5xx may succeed on replay.
+      // The post is left out: it is logged with the write already.
+      if (result.status < 500) {
+        const { post, ...answer } = result;
+        applied.set(mutation.key, answer);
+        logged = true;
+      }
+      return result;
+    });
+
+    // Writes and their keys are durable before anything is acknowledged
+    if (logged) {
+      await repository.sync();
+    }
+
+    return res.status(200).json({
+      success: true,
+      data: { results },
+    });
+  } catch (error) {
+    return res.status(500).json({
+      success: false,
+      error: 'Failed to apply mutations',
+    });
+  }
+}
+
+function applyMutation(
+  repository: PostRepository,
+  mutation: PostMutation,
+  placeholders: Map<string, string | undefined>
+): MutationResult {
+  const { key, postId } = mutation;
+  const fail = (status: number, error: string): MutationResult => ({ key, status, error });
+
+  switch (mutation.type) {
+    case 'create': {
+      const errors = checkCreatePost(mutation.data);
+      if (errors) {
+        return fail(400, errors.join('; '));
+      }
+      const { title, content, imageUrl }: CreatePostData = mutation.data;
+      if (repository.has(postId)) {
+        return fail(409, 'A post with this ID already exists');
+      }
+      const now = new Date().toISOString();
+      const post: Post = {
+        id: postId,
+        title,
+        content,
+        imageUrl: imageUrl || undefined,
+        imagePlaceholder: imageUrl ? placeholders.get(imageUrl) : undefined,
+        authorId: currentUser.id,
+        author: currentUser,
+        likes: 0,
+        likedBy: [],
+        createdAt: now,
+        updatedAt: now,
+      };
+      return { key, status: 201, post: repository.insert(post) };
+    }
+
+    case 'update': {
+      const post = repository.get(postId);
+      if (!post) {
+        return fail(404, 'Post not found');
+      }
+      if (post.authorId !== currentUser.id) {
+        return fail(403, 'Only the author can update this post');
+      }
+      const data = mutation.data || {};
+      const errors = checkUpdatePost(data);
+      if (errors) {
+        return fail(400, errors.join('; '));
+      }
+      const { title, content, imageUrl }: UpdatePostData = data;
+      const changes: PostChanges = { updatedAt: new Date().toISOString() };
+      if (title !== undefined) changes.title = title;
+      if (content !== undefined) changes.content = content;
+      if (imageUrl !== undefined) changes.imageUrl = imageUrl;
+      if (imageUrl !== undefined && imageUrl !== post.imageUrl) {
+        changes.imagePlaceholder = imageUrl ? placeholders.get(imageUrl) : undefined;
+      }
+      return { key, status: 200, post: repository.update(postId, changes) };
+    }
+
+    case 'delete': {
+      const post = repository.get(postId);
+      if (!post) {
+        return fail(404, 'Post not found');
+      }
+      if (post.authorId !== currentUser.id) {
+        return fail(403, 'Only the author can delete this post');
+      }
+      repository.remove(postId);
+      return { key, status: 200 };
+    }
+
+    case 'like': {
+      const { userId, liked } = mutation;
+      if (typeof liked !== 'boolean' || typeof userId !== 'string' || !userId) {
+        return fail(400, 'like needs a userId and a boolean liked');
+      }
+      const result = repository.setLike(postId, userId, liked);
+      return result ? { key, status: 200, post: repository.get(postId) } : fail(404, 'Post not found');
+    }
+
+    default:
+      return fail(400, 'Unknown mutation type');
+  }
+}
@@ -0,0 +1,42 @@
+import type { Server as HttpServer } from 'http';
+import type { Socket } from 'net';
+import type { NextApiRequest, NextApiResponse } from 'next';
+import { ApiResponse } from '@/types';
+import { getPostRepository } from '@/server/postRepository';
+import { REALTIME_PATH, attachRealtime, getRealtimeGateway } from '@/server/realtime';
+
+// WebSocket endpoint for realtime post events (protocol: types/websocket.ts).
+//
+// Next.js API routes cannot accept upgrades themselves, so a plain GET here
+// attaches the gateway to the underlying HTTP server; the client then opens
+// ws(s)://<host>/api/realtime?userId=<id>, which the gateway's upgrade
+// handler takes over. Repeated GETs are cheap no-ops.
+
+export default function handler(
+  req: NextApiRequest,
+  res: NextApiResponse<ApiResponse<{ path: string; connections: number }>>
+) {
+  if (req.method !== 'GET') {
+    res.setHeader('Allow', ['GET']);
+    return res.status(405).json({
+      success: false,
+      error: `Method ${req.method} not allowed`,
+    });
+  }
+
+  const server = (res.socket as (Socket & { server?: HttpServer }) | null)?.server;
+  if (!server) {
+    return res.status(503).json({
+      success: false,
+      error: 'Realtime is not available on this server',
+    });
+  }
+
+  const gateway = getRealtimeGateway(getPostRepository());
+  attachRealtime(server, gateway);
+
+  return res.status(200).json({
+    success: true,
+    data: { path: REALTIME_PATH, connections: gateway.stats.connections },
+  });
+}
@@ -1,4 +1,4 @@
-import { useEffect, useState } from 'react';
+import { useEffect, useMemo, useState } from 'react';
 import {
   Box,
   Container,
@@ -14,17 +14,54 @@ import {
 } from '@chakra-ui/react';
 import { AddIcon } from '@chakra-ui/icons';
 import Head from 'next/head';
+import type { GetServerSideProps } from 'next';
 
 import PostsList from '@/components/PostsList';
 import CreatePostModal from '@/components/CreatePostModal';
 import UserProfile from '@/components/UserProfile';
-import { usePostsStore } from '@/store/posts';
+import { getPostRepository } from '@/server/postRepository';
+import { FEED_PAGE_SIZE, PostsStoreProvider, usePosts, usePostsStore } from '@/store/posts';
+import { startTabSync } from '@/store/tabSync';
 import { useUserStore } from '@/store/users';
-import { PostFilters } from '@/types';
+import { Post, PostFilters, SyncCursor } from '@/types';
+import { createFeedSelector } from '@/utils/feedSelectors';
 
-export default function Home() {
+interface HomeProps {
+  initialPosts?: Post[];
+  initialVersion?: SyncCursor;
+}
+
+// The first page of the feed is rendered on the server, so the posts are in
+// the HTML (and in the store as soon as the page hydrates) instead of
+// arriving after the bundle loads and a client fetch completes.
+export const getServerSideProps: GetServerSideProps<HomeProps> = async () => {
+  const repository = getPostRepository();
+  const { posts } = repository.page({
+    sortBy: 'date',
+    sortOrder: 'desc',
+    limit: FEED_PAGE_SIZE,
+  });
+
+  // The client's delta sync resumes from the version the page was read at
+  const initialVersion = { epoch: repository.epoch, version: repository.version };
+
+  // Props must be plain JSON; optional fields may be undefined
+  return { props: { initialPosts: JSON.parse(JSON.stringify(posts)), initialVersion } };
+};
+
+export default function Home({ initialPosts, initialVersion }: HomeProps) {
+  return (
+    <PostsStoreProvider initialPosts={initialPosts} initialVersion={initialVersion}>
+      <Feed />
+    </PostsStoreProvider>
+  );
+}
+
+// Reads the posts store, so it must render inside PostsStoreProvider
+function Feed() {
   const { isOpen, onOpen, onClose } = useDisclosure();
-  const { posts, fetchPosts, createPost } = usePostsStore();
+  const posts = usePosts();
+  const createPost = usePostsStore(state => state.createPost);
   const { currentUser } = useUserStore();
   
   const [filters, setFilters] = useState<PostFilters>({
@@ -33,9 +70,15 @@ export default function Home() {
     sortOrder: 'desc',
   });
 
+  // Only the leader tab fetches, holds the realtime connection and syncs
+  // queued writes; the other tabs mirror its store (store/tabSync.ts)
+  const userId = currentUser ? currentUser.id : null;
   useEffect(() => {
-    fetchPosts();
-  }, [fetchPosts]);
+    if (!userId) {
+      return;
+    }
+    return startTabSync(userId);
+  }, [userId]);
 
   const handleCreatePost = async (data: any) => {
     await createPost(data);
@@ -46,35 +89,11 @@ export default function Home() {
     setFilters(prev => ({ ...prev, [key]: value }));
   };
 
-  // Filter and sort posts based on current filters
-  const filteredPosts = posts
-    .filter(post => {
-      if (filters.search) {
-        const searchLower = filters.search.toLowerCase();
-        return (
-          post.title.toLowerCase().includes(searchLower) ||
-          post.content.toLowerCase().includes(searchLower) ||
-          post.author.name.toLowerCase().includes(searchLower)
-        );
-      }
-      return true;
-    })
-    .filter(post => {
-      if (filters.authorId) {
-        return post.authorId === filters.authorId;
-      }
-      return true;
-    })
-    .sort((a, b) => {
-      if (filters.sortBy === 'date') {
-        const dateA = new Date(a.createdAt).getTime();
-        const dateB = new Date(b.createdAt).getTime();
-        return filters.sortOrder === 'desc' ? dateB - dateA : dateA - dateB;
-      } else if (filters.sortBy === 'popularity') {
-        return filters.sortOrder === 'desc' ? b.likes - a.likes : a.likes - b.likes;
-      }
-      return 0;
-    });
+  // Filter and sort posts based on current filters. The selector is memoized
+  // on (posts, filters) and patches its previous result incrementally, so a
+  // keystroke or a single like does not re-filter and re-sort the whole feed.
+  const [selectFeed] = useState(createFeedSelector);
+  const filteredPosts = useMemo(() => selectFeed(posts, filters), [selectFeed, posts, filters]);
 
   return (
     <>
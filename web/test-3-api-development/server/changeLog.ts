@@ -0,0 +1,142 @@
+import { SortedIndex } from './sortedIndex';
+
+// Version history of the post repository, used for ETags and delta sync.
+//
+// Every write bumps a global, monotonically increasing version. Only the
+// latest change per post is kept (ordered by version), so the log is bounded
+// by the number of live posts plus a capped number of delete tombstones.
+
+const MAX_TOMBSTONES = 10000;
+
+export interface ChangeRecord {
+  id: string;
+  version: number;
+  createdVersion: number;
+  deleted: boolean;
+}
+
+export interface ChangeSlice {
+  created: string[];
+  updated: string[];
+  deleted: string[];
+  version: number;
+  hasMore: boolean;
+  reset: boolean;
+}
+
+const compareByVersion = (a: ChangeRecord, b: ChangeRecord) => a.version - b.version;
+
+export class ChangeLog {
+  private records = new SortedIndex<ChangeRecord>(compareByVersion);
+  private latest = new Map<string, ChangeRecord>();
+  private tombstones: ChangeRecord[] = [];
+  private currentVersion = 0;
+  // Oldest `since` that can still be answered exactly; older clients must
+  // refetch because tombstones before it were dropped
+  private horizon = 0;
+
+  get version(): number {
+    return this.currentVersion;
+  }
+
+  // Version of the last write to one post (0 when unknown)
+  versionOf(id: string): number {
+    const record = this.latest.get(id);
+    return record && !record.deleted ? record.version : 0;
+  }
+
+  upserted(id: string): number {
+    const previous = this.latest.get(id);
+    const version = ++this.currentVersion;
+    const createdVersion = previous && !previous.deleted ? previous.createdVersion : version;
+
+    this.replace(previous, { id, version, createdVersion, deleted: false });
+    return version;
+  }
+
+  deleted(id: string): number {
+    const previous = this.latest.get(id);
+    const version = ++this.currentVersion;
+    const record: ChangeRecord = {
+      id,
+      version,
+      createdVersion: previous ? previous.createdVersion : version,
+      deleted: true,
+    };
+
+    this.replace(previous, record);
+    this.tombstones.push(record);
+    this.pruneTombstones();
+    return version;
+  }
+
+  // Ids changed after `since`, in version order, at most `limit` records
+  since(since: number, limit: number): ChangeSlice {
+    const slice: ChangeSlice = {
+      created: [],
+      updated: [],
+      deleted: [],
+      version: this.currentVersion,
+      hasMore: false,
+      reset: false,
+    };
+
+    if (since < this.horizon || since > this.currentVersion) {
+      slice.reset = true;
+      return slice;
+    }
+
+    let visited = 0;
+    const probe: ChangeRecord = { id: '', version: since, createdVersion: 0, deleted: false };
+
+    this.records.forEachFrom(this.records.seek('asc', probe), 'asc', record => {
+      if (visited === limit) {
+        slice.hasMore = true;
+        return false;
+      }
+      visited++;
+      slice.version = record.version;
+
+      if (record.deleted) {
+        // Posts created and deleted inside the window were never seen
+        if (record.createdVersion <= since) {
+          slice.deleted.push(record.id);
+        }
+      } else if (record.createdVersion > since) {
+        slice.created.push(record.id);
+      } else {
+        slice.updated.push(record.id);
+      }
+    });
+
+    if (!slice.hasMore) {
+      slice.version = this.currentVersion;
+    }
+    return slice;
+  }
+
+  private replace(previous: ChangeRecord | undefined, next: ChangeRecord): void {
+    if (previous) {
+      this.records.remove(previous);
+    }
+    this.records.insert(next);
+    this.latest.set(next.id, next);
+  }
+
+  // Drop the oldest tombstones in batches once over the cap
+  private pruneTombstones(): void {
+    const excess = this.tombstones.length - MAX_TOMBSTONES;
+    if (excess < MAX_TOMBSTONES / 10) {
+      return;
+    }
+
+    this.tombstones.splice(0, excess).forEach(record => {
+      this.horizon = Math.max(this.horizon, record.version);
+      // Skip tombstones already superseded by a re-created post
+      if (this.latest.get(record.id) === record) {
+        this.records.remove(record);
+        this.latest.delete(record.id);
+      }
+    });
+  }
+}
@@ -0,0 +1,36 @@
+import { PostKey, PostSortBy } from './postRepository';
+
+// Opaque keyset cursors for GET /api/posts.
+//
+// A cursor is the sort key of the last post on a page, base64url-encoded so
+// clients treat it as a token. The sort order is embedded so a cursor from a
+// date listing cannot be replayed against a popularity listing.
+
+type CursorPayload = [PostSortBy, number, number, string];
+
+export function encodeCursor(sortBy: PostSortBy, key: PostKey): string {
+  const payload: CursorPayload = [sortBy, key.time, key.likes, key.id];
+  return Buffer.from(JSON.stringify(payload)).toString('base64url');
+}
+
+// Returns null for malformed cursors or cursors from another sort order
+export function decodeCursor(sortBy: PostSortBy, cursor: string): PostKey | null {
+  try {
+    const payload = JSON.parse(Buffer.from(cursor, 'base64url').toString('utf8'));
+
+    if (
+      !Array.isArray(payload) ||
+      payload.length !== 4 ||
+      payload[0] !== sortBy ||
+      typeof payload[1] !== 'number' ||
+      typeof payload[2] !== 'number' ||
+      typeof payload[3] !== 'string'
+    ) {
+      return null;
+    }
+
+    return { time: payload[1], likes: payload[2], id: payload[3] };
+  } catch (error) {
+    return null;
+  }
+}
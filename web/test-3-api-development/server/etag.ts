@@ -0,0 +1,53 @@
+import type { NextApiRequest, NextApiResponse } from 'next';
+
+// Conditional GET helpers. ETags are derived from repository versions, so a
+// poll for unchanged data is answered with a bodyless 304 before anything is
+// serialized.
+
+export function versionEtag(epoch: string, version: number): string {
+  return `"${epoch}-${version}"`;
+}
+
+// Validator for a page of the change log: the changes after `since` up to
+// `version`. Pages read at the same store version differ by their range.
+export function rangeEtag(epoch: string, since: number, version: number): string {
+  return `"${epoch}-${since}-${version}"`;
+}
+
+function matchesIfNoneMatch(header: string | undefined, etag: string): boolean {
+  if (!header) {
+    return false;
+  }
+  if (header.trim() === '*') {
+    return true;
+  }
+  // Weak comparison per RFC 9110: a W/ prefix on the client's copy still matches
+  return header.split(',').some(candidate => candidate.trim().replace(/^W\//, '') === etag);
+}
+
+// Compare-and-swap precondition for writes. If-Match uses strong comparison,
+// so weak validators never match. Absent header means "no precondition".
+export function ifMatchFails(req: NextApiRequest, etag: string): boolean {
+  const header = req.headers['if-match'];
+  if (!header || header.trim() === '*') {
+    return false;
+  }
+  return !header.split(',').some(candidate => candidate.trim() === etag);
+}
+
+// Sets the ETag and answers 304 when the client already has this version.
+// Returns true when the response has been sent.
+export function respondIfFresh(
+  req: NextApiRequest,
+  res: NextApiResponse,
+  etag: string
+): boolean {
+  res.setHeader('ETag', etag);
+  res.setHeader('Cache-Control', 'private, no-cache');
+
+  if (matchesIfNoneMatch(req.headers['if-none-match'], etag)) {
+    res.status(304).end();
+    return true;
+  }
+  return false;
+}
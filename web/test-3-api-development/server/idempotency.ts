@@ -0,0 +1,113 @@
+// Results of recently applied writes by idempotency key, so a client that
+// replays a request (after a timeout, or from its offline outbox) gets the
+// original answer instead of applying the write twice.
+//
+// Bounded by entry count and age; the oldest keys go first (Map iteration
+// order is insertion order). A replay arriving after its key was evicted
+// is applied again, so the window must outlast client retry horizons.
+//
+// With a log attached (server/persistence.ts) every stored answer is also
+// written to the posts write-ahead log, so keys survive a restart together
+// with the writes they answer for.
+
+export interface IdempotencyOptions {
+  maxEntries?: number;
+  ttl?: number; // ms a key is remembered
+  now?: () => number;
+}
+
+export interface IdempotencyEntry<T> {
+  key: string;
+  value: T;
+  storedAt: number;
+}
+
+export interface IdempotencyLog<T> {
+  append(entry: IdempotencyEntry<T>): void;
+}
+
+export class IdempotencyStore<T> {
+  private entries = new Map<string, { value: T; storedAt: number }>();
+  private log: IdempotencyLog<T> | null = null;
+  private readonly maxEntries: number;
+  private readonly ttl: number;
+  private readonly now: () => number;
+
+  constructor(options: IdempotencyOptions = {}) {
+    this.maxEntries = options.maxEntries || 10000;
+    this.ttl = options.ttl || 24 * 60 * 60 * 1000;
+    this.now = options.now || Date.now;
+  }
+
+  get size(): number {
+    return this.entries.size;
+  }
+
+  get(key: string): T | undefined {
+    const entry = this.entries.get(key);
+    if (!entry) {
+      return undefined;
+    }
+    if (this.now() - entry.storedAt > this.ttl) {
+      this.entries.delete(key);
+      return undefined;
+    }
+    return entry.value;
+  }
+
+  set(key: string, value: T): void {
+    const storedAt = this.now();
+    this.put(key, value, storedAt);
+    if (this.log) {
+      this.log.append({ key, value, storedAt });
+    }
+  }
+
+  // Record every subsequent set() in `log`
+  attachLog(log: IdempotencyLog<T>): void {
+    this.log = log;
+  }
+
+  // Re-add a logged entry (startup only); expired entries are skipped
+  restore(entry: IdempotencyEntry<T>): void {
+    if (this.now() - entry.storedAt <= this.ttl) {
+      this.put(entry.key, entry.value, entry.storedAt);
+    }
+  }
+
+  // Live entries, oldest first (for snapshots)
+  list(): IdempotencyEntry<T>[] {
+    const now = this.now();
+    const live: IdempotencyEntry<T>[] = [];
+    this.entries.forEach(({ value, storedAt }, key) => {
+      if (now - storedAt <= this.ttl) {
+        live.push({ key, value, storedAt });
+      }
+    });
+    return live;
+  }
+
+  private put(key: string, value: T, storedAt: number): void {
+    this.entries.delete(key);
+    this.entries.set(key, { value, storedAt });
+    while (this.entries.size > this.maxEntries) {
+      this.entries.delete(this.entries.keys().next().value as string);
+    }
+  }
+}
+
+const globalForIdempotency = globalThis as typeof globalThis & {
+  __idempotencyStore?: IdempotencyStore<unknown>;
+};
+
+export function getIdempotencyStore<T>(): IdempotencyStore<T> {
+  if (!globalForIdempotency.__idempotencyStore) {
+    globalForIdempotency.__idempotencyStore = new IdempotencyStore();
+  }
+  return globalForIdempotency.__idempotencyStore as IdempotencyStore<T>;
+}
+
+// Swap the shared instance (used by tests to simulate a restart)
+export function setIdempotencyStore<T>(store: IdempotencyStore<T>): void {
+  globalForIdempotency.__idempotencyStore = store as IdempotencyStore<unknown>;
+}
@@ -0,0 +1,63 @@
+import { imageVariant, isResizable } from '@/utils/images';
+
+// Tiny blurred stand-ins for post images, computed once when a post is
+// created or its image changes and stored on the post as a data URI. The
+// feed paints them immediately (inline, no extra request) and swaps in the
+// real image when it loads.
+//
+// Only images on a resizing CDN get one: the CDN returns a ~16px wide
+// thumbnail of a few hundred bytes. Anything else would mean downloading
+// the full image on the write path, so those posts go without.
+
+const PLACEHOLDER_WIDTH = 16;
+const PLACEHOLDER_TIMEOUT_MS = 1500;
+const MAX_PLACEHOLDER_BYTES = 2048;
+const MAX_CACHED = 500;
+
+type Fetch = (url: string, init: { signal: AbortSignal }) => Promise<{
+  ok: boolean;
+  headers: { get(name: string): string | null };
+  arrayBuffer(): Promise<ArrayBuffer>;
+}>;
+
+// Recent results by image URL (the same image is often posted repeatedly)
+const cache = new Map<string, string | undefined>();
+
+export async function createImagePlaceholder(
+  url: string,
+  fetcher: Fetch = fetch as unknown as Fetch
+): Promise<string | undefined> {
+  if (!isResizable(url)) {
+    return undefined;
+  }
+  if (cache.has(url)) {
+    return cache.get(url);
+  }
+
+  const controller = new AbortController();
+  const timer = setTimeout(() => controller.abort(), PLACEHOLDER_TIMEOUT_MS);
+  let placeholder: string | undefined;
+
+  try {
+    const thumbnail = imageVariant(url, PLACEHOLDER_WIDTH, { quality: 40, format: 'jpg' });
+    const response = await fetcher(thumbnail, { signal: controller.signal });
+    const type = response.headers.get('Content-Type') || '';
+    if (response.ok && type.indexOf('image/') === 0) {
+      const bytes = Buffer.from(await response.arrayBuffer());
+      if (bytes.length <= MAX_PLACEHOLDER_BYTES) {
+        placeholder = `data:${type.split(';')[0]};base64,${bytes.toString('base64')}`;
+      }
+    }
+  } catch (error) {
+    // A slow or failing CDN must not fail the write; the post just has no placeholder
+    return undefined;
+  } finally {
+    clearTimeout(timer);
+  }
+
+  cache.set(url, placeholder);
+  if (cache.size > MAX_CACHED) {
+    cache.delete(cache.keys().next().value as string);
+  }
+  return placeholder;
+}
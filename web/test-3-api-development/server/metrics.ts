@@ -0,0 +1,293 @@
+import type { NextApiHandler, NextApiRequest } from 'next';
+import { performance } from 'perf_hooks';
+
+// Per-route request metrics for the API handlers, exposed in Prometheus
+// text format by pages/api/metrics.ts.
+//
+// Latencies and payload sizes go into log-linear histograms in the style of
+// HdrHistogram: each power of two is split into SUB_BUCKETS linear buckets,
+// so every value is kept to within about 3% in a fixed array of counters.
+// Recording is a couple of integer operations and no allocation, and
+// quantiles (p50/p99/p999) are read straight from the counters.
+//
+// Buckets include their upper bound, (lower, upper], like Prometheus `le`
+// buckets, so powers of two cut exact cumulative counts for the exposition.
+
+const SUB_BUCKETS = 32; // Per power of two
+const SUB_BITS = 5; // log2(SUB_BUCKETS)
+const LINEAR_LIMIT = 2 * SUB_BUCKETS; // Values up to this get a bucket each
+const MAX_VALUE = 0x7fffffff;
+const BUCKET_COUNT = 1 + LINEAR_LIMIT + (31 - SUB_BITS - 1) * SUB_BUCKETS;
+
+function bucketIndex(value: number): number {
+  // Fractions round up, so a value never lands below its own bound
+  const v = value <= 0 ? 0 : Math.min(MAX_VALUE, Math.ceil(value));
+  if (v <= LINEAR_LIMIT) {
+    return v;
+  }
+  // v - 1 indexes [lower, upper) buckets, which shifts them to (lower, upper]
+  const below = v - 1;
+  const exponent = 31 - Math.clz32(below);
+  const shift = exponent - SUB_BITS;
+  return 1 + LINEAR_LIMIT + (exponent - SUB_BITS - 1) * SUB_BUCKETS + ((below >> shift) - SUB_BUCKETS);
+}
+
+// Inclusive upper bound of bucket `index`
+function bucketLimit(index: number): number {
+  if (index <= LINEAR_LIMIT) {
+    return index;
+  }
+  const offset = index - LINEAR_LIMIT - 1;
+  const exponent = Math.floor(offset / SUB_BUCKETS) + SUB_BITS + 1;
+  const width = Math.pow(2, exponent - SUB_BITS);
+  return (SUB_BUCKETS + (offset % SUB_BUCKETS) + 1) * width;
+}
+
+// Histogram of non-negative integers (microseconds, bytes)
+export class LogHistogram {
+  private counts = new Float64Array(BUCKET_COUNT);
+  count = 0;
+  sum = 0;
+
+  record(value: number): void {
+    this.counts[bucketIndex(value)]++;
+    this.count++;
+    this.sum += value;
+  }
+
+  // Upper bound of the bucket holding the `q` quantile (0 when empty)
+  quantile(q: number): number {
+    if (this.count === 0) {
+      return 0;
+    }
+    const rank = Math.max(1, Math.ceil(q * this.count));
+    let seen = 0;
+    for (let i = 0; i < BUCKET_COUNT; i++) {
+      seen += this.counts[i];
+      if (seen >= rank) {
+        return bucketLimit(i);
+      }
+    }
+    return MAX_VALUE;
+  }
+
+  // Number of values at or below each bound (Prometheus `le`). Bounds must
+  // be ascending powers of two, which close a bucket, so the counts are exact.
+  cumulative(bounds: number[]): number[] {
+    const result: number[] = [];
+    let seen = 0;
+    let index = 0;
+    bounds.forEach(bound => {
+      const end = bucketIndex(bound);
+      for (; index <= end; index++) {
+        seen += this.counts[index];
+      }
+      result.push(seen);
+    });
+    return result;
+  }
+}
+
+export interface RouteMetrics {
+  route: string;
+  method: string;
+  latency: LogHistogram; // Microseconds
+  requestBytes: LogHistogram;
+  responseBytes: LogHistogram;
+  statuses: Map<number, number>;
+}
+
+const METHODS = ['GET', 'HEAD', 'POST', 'PUT', 'PATCH', 'DELETE', 'OPTIONS'];
+
+export class ApiMetrics {
+  private series = new Map<string, RouteMetrics>();
+
+  get routes(): RouteMetrics[] {
+    return Array.from(this.series.values());
+  }
+
+  get(route: string, method: string): RouteMetrics {
+    // Unknown methods share one series, so clients cannot grow the registry
+    const name = METHODS.indexOf(method) === -1 ? 'OTHER' : method;
+    const key = `${route} ${name}`;
+    let metrics = this.series.get(key);
+    if (!metrics) {
+      metrics = {
+        route,
+        method: name,
+        latency: new LogHistogram(),
+        requestBytes: new LogHistogram(),
+        responseBytes: new LogHistogram(),
+        statuses: new Map(),
+      };
+      this.series.set(key, metrics);
+    }
+    return metrics;
+  }
+
+  record(
+    route: string,
+    method: string,
+    status: number,
+    micros: number,
+    requestBytes: number,
+    responseBytes: number
+  ): void {
+    const metrics = this.get(route, method);
+    metrics.latency.record(micros);
+    metrics.requestBytes.record(requestBytes);
+    metrics.responseBytes.record(responseBytes);
+    metrics.statuses.set(status, (metrics.statuses.get(status) || 0) + 1);
+  }
+}
+
+const globalForMetrics = globalThis as typeof globalThis & {
+  __apiMetrics?: ApiMetrics;
+};
+
+export function getApiMetrics(): ApiMetrics {
+  if (!globalForMetrics.__apiMetrics) {
+    globalForMetrics.__apiMetrics = new ApiMetrics();
+  }
+  return globalForMetrics.__apiMetrics;
+}
+
+// Swap the shared instance (used by tests to start from empty metrics)
+export function setApiMetrics(metrics: ApiMetrics): void {
+  globalForMetrics.__apiMetrics = metrics;
+}
+
+function chunkBytes(chunk: unknown): number {
+  if (typeof chunk === 'string') {
+    return Buffer.byteLength(chunk);
+  }
+  return chunk && typeof (chunk as Uint8Array).byteLength === 'number' ? (chunk as Uint8Array).byteLength : 0;
+}
+
+function requestBytes(req: NextApiRequest): number {
+  const length = Number(req.headers['content-length']);
+  return length > 0 ? length : 0;
+}
+
+type Writable = { write?: (...args: unknown[]) => unknown; end?: (...args: unknown[]) => unknown };
+
+// Records latency, payload sizes and status of every request to `route`.
+// Latency runs until the handler returns, or until its promise settles
+// for async handlers (which all await their writes and streams).
+export function withMetrics<T>(route: string, handler: NextApiHandler<T>): NextApiHandler<T> {
+  return (req, res) => {
+    const start = performance.now();
+    const target = res as unknown as Writable;
+    let responseBytes = 0;
+
+    // Count the body as it is written, without serializing it again
+    const { write, end } = target;
+    if (write) {
+      target.write = (...args: unknown[]) => {
+        responseBytes += chunkBytes(args[0]);
+        return write.apply(res, args);
+      };
+    }
+    if (end) {
+      target.end = (...args: unknown[]) => {
+        responseBytes += chunkBytes(args[0]);
+        return end.apply(res, args);
+      };
+    }
+
+    const done = () => {
+      const micros = (performance.now() - start) * 1000;
+      getApiMetrics().record(route, req.method || 'GET', res.statusCode, micros, requestBytes(req), responseBytes);
+    };
+
+    let result: unknown;
+    try {
+      result = handler(req, res);
+    } catch (error) {
+      res.statusCode = 500;
+      done();
+      throw error;
+    }
+
+    if (result && typeof (result as Promise<unknown>).then === 'function') {
+      (result as Promise<unknown>).then(done, done);
+    } else {
+      done();
+    }
+    return result as ReturnType<NextApiHandler<T>>;
+  };
+}
+
+// Prometheus text exposition (format 0.0.4)
+
+const LATENCY_BOUNDS: number[] = []; // µs: 64µs to ~16.8s, doubling
+for (let bound = 64; bound <= 1 << 24; bound *= 2) {
+  LATENCY_BOUNDS.push(bound);
+}
+const SIZE_BOUNDS: number[] = []; // Bytes: 64B to 16MB, x4
+for (let bound = 64; bound <= 1 << 24; bound *= 4) {
+  SIZE_BOUNDS.push(bound);
+}
+const QUANTILES = [0.5, 0.9, 0.99, 0.999];
+
+function labels(metrics: RouteMetrics, extra = ''): string {
+  return `route="${metrics.route}",method="${metrics.method}"${extra}`;
+}
+
+function histogramLines(
+  name: string,
+  series: RouteMetrics[],
+  pick: (metrics: RouteMetrics) => LogHistogram,
+  bounds: number[],
+  scale: number
+): string[] {
+  const lines: string[] = [];
+  series.forEach(metrics => {
+    const histogram = pick(metrics);
+    const counts = histogram.cumulative(bounds);
+    bounds.forEach((bound, i) => {
+      lines.push(`${name}_bucket{${labels(metrics, `,le="${bound / scale}"`)}} ${counts[i]}`);
+    });
+    lines.push(`${name}_bucket{${labels(metrics, ',le="+Inf"')}} ${histogram.count}`);
+    lines.push(`${name}_sum{${labels(metrics)}} ${histogram.sum / scale}`);
+    lines.push(`${name}_count{${labels(metrics)}} ${histogram.count}`);
+  });
+  return lines;
+}
+
+export function formatPrometheus(metrics: ApiMetrics): string {
+  const series = metrics.routes;
+  const lines: string[] = [];
+
+  lines.push('# HELP api_request_duration_seconds Time from a request reaching its handler to the response.');
+  lines.push('# TYPE api_request_duration_seconds histogram');
+  lines.push(...histogramLines('api_request_duration_seconds', series, m => m.latency, LATENCY_BOUNDS, 1e6));
+
+  lines.push('# HELP api_request_latency_seconds Request duration quantiles since the server started.');
+  lines.push('# TYPE api_request_latency_seconds summary');
+  series.forEach(m => {
+    QUANTILES.forEach(q => {
+      lines.push(`api_request_latency_seconds{${labels(m, `,quantile="${q}"`)}} ${m.latency.quantile(q) / 1e6}`);
+    });
+    lines.push(`api_request_latency_seconds_sum{${labels(m)}} ${m.latency.sum / 1e6}`);
+    lines.push(`api_request_latency_seconds_count{${labels(m)}} ${m.latency.count}`);
+  });
+
+  lines.push('# HELP api_request_size_bytes Request body size (Content-Length).');
+  lines.push('# TYPE api_request_size_bytes histogram');
+  lines.push(...histogramLines('api_request_size_bytes', series, m => m.requestBytes, SIZE_BOUNDS, 1));
+
+  lines.push('# HELP api_response_size_bytes Response body size as written.');
+  lines.push('# TYPE api_response_size_bytes histogram');
+  lines.push(...histogramLines('api_response_size_bytes', series, m => m.responseBytes, SIZE_BOUNDS, 1));
+
+  lines.push('# HELP api_responses_total Responses by status code.');
+  lines.push('# TYPE api_responses_total counter');
+  series.forEach(m => {
+    m.statuses.forEach((count, status) => {
+      lines.push(`api_responses_total{${labels(m, `,status="${status}"`)}} ${count}`);
+    });
+  });
+
+  return lines.join('\n') + '\n';
+}
@@ -0,0 +1,105 @@
+import { Post } from '@/types';
+import { WriteAheadLog } from './writeAheadLog';
+import { IdempotencyEntry, IdempotencyStore, getIdempotencyStore } from './idempotency';
+import type { PostOperation, PostRepository } from './postRepository';
+
+// Durability for the in-memory post repository without a database.
+//
+// Every write is appended to a write-ahead log (group-committed, so one
+// fdatasync covers all writes that arrive while the previous one runs). A
+// compacted snapshot of all posts is written every SNAPSHOT_EVERY operations
+// and at most every SNAPSHOT_INTERVAL_MS, after which the covered log
+// segments are deleted. Startup loads the snapshot and replays the log tail.
+//
+// Idempotency keys (server/idempotency.ts) share the log and the snapshot,
+// so a client replaying its outbox after a restart still gets the stored
+// answer for a write that was already applied, not a conflict.
+
+const SNAPSHOT_EVERY = 50000;
+const SNAPSHOT_INTERVAL_MS = 5 * 60 * 1000;
+
+type KeyRecord = { op: 'key' } & IdempotencyEntry<unknown>;
+type PersistedRecord = PostOperation | KeyRecord;
+
+const isKeyRecord = (record: object): record is KeyRecord => (record as KeyRecord).op === 'key';
+
+// Load `dir` into an empty repository (and `keys`) and log all further
+// writes there. Returns false when there was nothing to restore.
+export function attachPersistence(
+  repository: PostRepository,
+  dir: string,
+  keys: IdempotencyStore<unknown> = getIdempotencyStore()
+): boolean {
+  const wal = new WriteAheadLog<PersistedRecord>(dir);
+  const startedAt = Date.now();
+
+  const loaded = wal.load<Post | KeyRecord>(
+    record => (isKeyRecord(record) ? keys.restore(record) : repository.insert(record)),
+    record => (isKeyRecord(record) ? keys.restore(record) : repository.apply(record))
+  );
+
+  if (loaded.lastLsn > 0) {
+    console.log(
+      `Restored ${repository.size} posts from ${dir} ` +
+        `(${loaded.snapshotRecords} snapshot records, ${loaded.logRecords} log records) ` +
+        `in ${Date.now() - startedAt}ms`
+    );
+  }
+
+  wal.open().catch(error => {
+    console.error(`Failed to open write-ahead log in ${dir}`, error);
+  });
+
+  let sinceSnapshot = loaded.logRecords;
+  let snapshotting = false;
+
+  const takeSnapshot = () => {
+    if (snapshotting || sinceSnapshot === 0) {
+      return;
+    }
+    snapshotting = true;
+    sinceSnapshot = 0;
+
+    // Posts are immutable, so this list is a consistent view of the state at
+    // the rotation point even while later writes keep coming in
+    const records: (Post | KeyRecord)[] = repository.list();
+    keys.list().forEach(entry => records.push({ op: 'key', ...entry }));
+    wal
+      .rotate()
+      .then(lsn => wal.writeSnapshot(lsn, records))
+      .catch(error => {
+        console.error('Failed to write posts snapshot', error);
+      })
+      .then(() => {
+        snapshotting = false;
+      });
+  };
+
+  repository.attachLog({
+    append(operation) {
+      wal.append(operation);
+      if (++sinceSnapshot >= SNAPSHOT_EVERY) {
+        takeSnapshot();
+      }
+    },
+    sync: () => wal.sync(),
+  });
+  keys.attachLog({
+    append(entry) {
+      wal.append({ op: 'key', ...entry });
+      sinceSnapshot++;
+    },
+  });
+
+  // Compact a long log left by the previous run right away
+  if (sinceSnapshot >= SNAPSHOT_EVERY) {
+    takeSnapshot();
+  }
+
+  const timer = setInterval(takeSnapshot, SNAPSHOT_INTERVAL_MS);
+  if (timer.unref) {
+    timer.unref();
+  }
+
+  return loaded.lastLsn > 0;
+}
@@ -0,0 +1,512 @@
+import path from 'path';
+import { Post, PostChangeSet } from '@/types';
+import { mockPosts } from '@/utils/mockData';
+import { SortedIndex, IndexDirection } from './sortedIndex';
+import { SearchIndex } from './searchIndex';
+import { ChangeLog } from './changeLog';
+import { attachPersistence } from './persistence';
+
+// Shared in-memory store behind the /api/posts routes.
+//
+// Posts live in a Map keyed by id (O(1) lookups) and are mirrored into sorted
+// indexes by date, by popularity and by date per author, so listing a feed
+// never has to sort and writes only touch O(log n) of each index. Title,
+// content and author name are also kept in a full-text SearchIndex, and every
+// write is recorded in a ChangeLog that versions the store for ETags and
+// delta sync.
+
+export type PostSortBy = 'date' | 'popularity';
+
+export interface PostListOptions {
+  sortBy?: PostSortBy;
+  sortOrder?: IndexDirection;
+  authorId?: string;
+}
+
+// Position of a post in a sorted listing, used as the keyset for pagination
+export interface PostKey {
+  id: string;
+  time: number;
+  likes: number;
+}
+
+export interface PostPageOptions extends PostListOptions {
+  limit: number;
+  after?: PostKey;
+  search?: string;
+}
+
+export interface LikeResult {
+  likes: number;
+  liked: boolean;
+  changed: boolean;
+}
+
+export interface PostPage {
+  posts: Post[];
+  total: number;
+  hasMore: boolean;
+}
+
+export type PostChanges = Partial<Omit<Post, 'id' | 'authorId' | 'createdAt'>>;
+
+// Logical write operations, as recorded by a persistence log and replayed
+// through apply() on startup
+export type PostOperation =
+  | { op: 'insert'; post: Post }
+  | { op: 'update'; id: string; changes: PostChanges }
+  | { op: 'delete'; id: string }
+  | { op: 'like'; id: string; userId: string; liked: boolean };
+
+// Notified after every write with the operation that was applied
+export type PostListener = (operation: PostOperation) => void;
+
+export interface PostOperationLog {
+  append(operation: PostOperation): void;
+  // Resolves once every appended operation is durable
+  sync(): Promise<void>;
+}
+
+// Index entries cache the parsed timestamp so comparators never parse dates.
+// Once a post has been liked through setLike, `likers` is the source of
+// truth for who likes it: a toggle is O(1) and only marks post.likedBy
+// stale, and the array is rebuilt when the full post is next read.
+export interface PostEntry {
+  post: Post;
+  time: number;
+  likers?: Set<string>;
+  likedByStale?: boolean;
+}
+
+export const compareByDate = (a: PostEntry, b: PostEntry): number => {
+  if (a.time !== b.time) {
+    return a.time - b.time;
+  }
+  return a.post.id < b.post.id ? -1 : a.post.id > b.post.id ? 1 : 0;
+};
+
+export const compareByPopularity = (a: PostEntry, b: PostEntry): number => {
+  if (a.post.likes !== b.post.likes) {
+    return a.post.likes - b.post.likes;
+  }
+  return compareByDate(a, b);
+};
+
+export class PostRepository {
+  private entries = new Map<string, PostEntry>();
+  private byDate = new SortedIndex<PostEntry>(compareByDate);
+  private byPopularity = new SortedIndex<PostEntry>(compareByPopularity);
+  private byAuthor = new Map<string, SortedIndex<PostEntry>>();
+  private searchIndex = new SearchIndex();
+  private changeLog = new ChangeLog();
+  private log: PostOperationLog | null = null;
+  private listeners: PostListener[] = [];
+  // Distinguishes server runs, so versions from a previous process (which
+  // restart from zero) are never mistaken for current ones
+  readonly epoch = Date.now().toString(36);
+
+  constructor(initialPosts: Post[] = []) {
+    initialPosts.forEach(post => this.insert(post));
+  }
+
+  get size(): number {
+    return this.entries.size;
+  }
+
+  // Bumped by every write; identifies the state of the whole store
+  get version(): number {
+    return this.changeLog.version;
+  }
+
+  // Version of the last write to one post
+  versionOf(id: string): number {
+    return this.changeLog.versionOf(id);
+  }
+
+  // Record every subsequent write in `log`
+  attachLog(log: PostOperationLog): void {
+    this.log = log;
+  }
+
+  // Observe every subsequent write (e.g. to push it to realtime clients)
+  subscribe(listener: PostListener): () => void {
+    this.listeners = this.listeners.concat(listener);
+    return () => {
+      this.listeners = this.listeners.filter(other => other !== listener);
+    };
+  }
+
+  // Resolves when all writes so far are durable (immediately without a log).
+  // Write handlers await this before acknowledging.
+  sync(): Promise<void> {
+    return this.log ? this.log.sync() : Promise.resolve();
+  }
+
+  // Replay one logged operation
+  apply(operation: PostOperation): void {
+    switch (operation.op) {
+      case 'insert':
+        this.insert(operation.post);
+        break;
+      case 'update':
+        this.update(operation.id, operation.changes);
+        break;
+      case 'delete':
+        this.remove(operation.id);
+        break;
+      case 'like':
+        this.setLike(operation.id, operation.userId, operation.liked);
+        break;
+    }
+  }
+
+  has(id: string): boolean {
+    return this.entries.has(id);
+  }
+
+  get(id: string): Post | undefined {
+    const entry = this.entries.get(id);
+    return entry ? postOf(entry) : undefined;
+  }
+
+  // Like count without building the full post (cheap on hot posts)
+  likeCount(id: string): number | undefined {
+    const entry = this.entries.get(id);
+    return entry ? entry.post.likes : undefined;
+  }
+
+  insert(post: Post): Post {
+    const existing = this.entries.get(post.id);
+    if (existing) {
+      this.unindex(existing);
+    }
+
+    const entry: PostEntry = { post, time: Date.parse(post.createdAt) };
+    this.entries.set(post.id, entry);
+    this.byDate.insert(entry);
+    this.byPopularity.insert(entry);
+    this.authorIndex(post.authorId).insert(entry);
+    this.searchIndex.add(post.id, searchableText(post));
+    this.changeLog.upserted(post.id);
+    this.record({ op: 'insert', post });
+    return post;
+  }
+
+  update(id: string, changes: PostChanges): Post | undefined {
+    const entry = this.applyChanges(id, changes);
+    if (!entry) {
+      return undefined;
+    }
+    this.record({ op: 'update', id, changes });
+    return postOf(entry);
+  }
+
+  // Like or unlike a post for one user (toggles when `liked` is omitted).
+  // Runs synchronously, so concurrent requests are applied one at a time and
+  // the counter always moves together with set membership.
+  setLike(id: string, userId: string, liked?: boolean): LikeResult | undefined {
+    const entry = this.entries.get(id);
+    if (!entry) {
+      return undefined;
+    }
+
+    const likers = entry.likers || (entry.likers = new Set(entry.post.likedBy));
+    const wasLiked = likers.has(userId);
+    const target = liked === undefined ? !wasLiked : liked;
+
+    if (target === wasLiked) {
+      return { likes: entry.post.likes, liked: wasLiked, changed: false };
+    }
+
+    // The seed data counts likes from users outside likedBy, so the counter
+    // moves by one with each membership change rather than mirroring size
+    if (target) {
+      likers.add(userId);
+    } else {
+      likers.delete(userId);
+    }
+
+    const likes = entry.post.likes + (target ? 1 : -1);
+    const updated = this.applyChanges(id, { likes }) as PostEntry;
+    updated.likers = likers;
+    updated.likedByStale = true;
+    // Logged as the intent, not the new likedBy array, so hot posts stay cheap to log
+    this.record({ op: 'like', id, userId, liked: target });
+    return { likes, liked: target, changed: true };
+  }
+
+  remove(id: string): Post | undefined {
+    const entry = this.entries.get(id);
+    if (!entry) {
+      return undefined;
+    }
+
+    this.entries.delete(id);
+    this.unindex(entry);
+    this.searchIndex.remove(id);
+    this.changeLog.deleted(id);
+    this.record({ op: 'delete', id });
+    return postOf(entry);
+  }
+
+  // Sorted index for a listing; author listings are only kept by date, so
+  // popularity within one author falls back to the global index + filter
+  index(options: PostListOptions = {}): SortedIndex<PostEntry> {
+    if (options.authorId && options.sortBy !== 'popularity') {
+      return this.byAuthor.get(options.authorId) || new SortedIndex(compareByDate);
+    }
+    return options.sortBy === 'popularity' ? this.byPopularity : this.byDate;
+  }
+
+  // Number of posts a listing with these options covers
+  count(options: PostListOptions = {}): number {
+    if (options.authorId) {
+      const authorIndex = this.byAuthor.get(options.authorId);
+      return authorIndex ? authorIndex.size : 0;
+    }
+    return this.entries.size;
+  }
+
+  // Visit posts in listing order, optionally resuming strictly after `after`.
+  // Seeking is O(log n); each visited post is O(1).
+  forEach(
+    options: PostListOptions,
+    visit: (post: Post) => boolean | void,
+    after?: PostKey
+  ): void {
+    const { authorId, sortOrder = 'desc' } = options;
+    const filterByAuthor = !!authorId && options.sortBy === 'popularity';
+    const index = this.index(options);
+    const probe = after ? entryForKey(after) : undefined;
+
+    index.forEachFrom(index.seek(sortOrder, probe), sortOrder, entry => {
+      if (filterByAuthor && entry.post.authorId !== authorId) {
+        return true;
+      }
+      return visit(postOf(entry));
+    });
+  }
+
+  // One keyset page: O(log n + limit) regardless of how deep the page is
+  page(options: PostPageOptions): PostPage {
+    if (options.search && options.search.trim()) {
+      const matches = this.searchIndex.search(options.search);
+      // A search made only of punctuation matches nothing, not everything
+      return matches
+        ? this.searchPage(matches, options)
+        : { posts: [], total: 0, hasMore: false };
+    }
+
+    const posts: Post[] = [];
+    let hasMore = false;
+
+    this.forEach(
+      options,
+      post => {
+        if (posts.length === options.limit) {
+          hasMore = true;
+          return false;
+        }
+        posts.push(post);
+      },
+      options.after
+    );
+
+    return { posts, total: this.count(options), hasMore };
+  }
+
+  list(options: PostListOptions = {}): Post[] {
+    const posts: Post[] = [];
+    this.forEach(options, post => {
+      posts.push(post);
+    });
+    return posts;
+  }
+
+  // Posts created, updated and deleted after version `since`
+  changesSince(since: number, limit: number): PostChangeSet {
+    const slice = this.changeLog.since(since, limit);
+    const toPost = (id: string) => postOf(this.entries.get(id) as PostEntry);
+
+    return {
+      epoch: this.epoch,
+      version: slice.version,
+      created: slice.created.map(toPost),
+      updated: slice.updated.map(toPost),
+      deleted: slice.deleted,
+      hasMore: slice.hasMore,
+      reset: slice.reset,
+    };
+  }
+
+  keyOf(post: Post): PostKey {
+    const entry = this.entries.get(post.id);
+    return {
+      id: post.id,
+      time: entry ? entry.time : Date.parse(post.createdAt),
+      likes: post.likes,
+    };
+  }
+
+  // Selective queries sort their matches directly (O(m log m)). Broad ones
+  // walk the sorted index and skip non-matches instead: when at least 1/8 of
+  // the listing matches, a page visits fewer than 8 * limit entries.
+  private searchPage(matches: ReadonlySet<string>, options: PostPageOptions): PostPage {
+    const { authorId, after, limit, sortOrder = 'desc' } = options;
+
+    if (!authorId && matches.size * 8 >= this.entries.size) {
+      const posts: Post[] = [];
+      let hasMore = false;
+
+      this.forEach(
+        options,
+        post => {
+          if (!matches.has(post.id)) {
+            return true;
+          }
+          if (posts.length === limit) {
+            hasMore = true;
+            return false;
+          }
+          posts.push(post);
+        },
+        after
+      );
+      return { posts, total: matches.size, hasMore };
+    }
+
+    const compare = options.sortBy === 'popularity' ? compareByPopularity : compareByDate;
+    const direction = sortOrder === 'asc' ? 1 : -1;
+    const probe = after ? entryForKey(after) : undefined;
+
+    const candidates: PostEntry[] = [];
+    let total = 0;
+
+    matches.forEach(id => {
+      const entry = this.entries.get(id);
+      if (!entry || (authorId && entry.post.authorId !== authorId)) {
+        return;
+      }
+      total++;
+      if (!probe || compare(entry, probe) * direction > 0) {
+        candidates.push(entry);
+      }
+    });
+
+    candidates.sort((a, b) => compare(a, b) * direction);
+
+    return {
+      posts: candidates.slice(0, limit).map(postOf),
+      total,
+      hasMore: candidates.length > limit,
+    };
+  }
+
+  // Posts are treated as immutable: an update stores a new object so
+  // references handed out earlier never change under the caller
+  private applyChanges(id: string, changes: PostChanges): PostEntry | undefined {
+    const previous = this.entries.get(id);
+    if (!previous) {
+      return undefined;
+    }
+
+    const post: Post = { ...previous.post, ...changes };
+    const entry: PostEntry = {
+      post,
+      time: previous.time,
+      likers: changes.likedBy ? undefined : previous.likers,
+      likedByStale: changes.likedBy ? false : previous.likedByStale,
+    };
+
+    this.entries.set(id, entry);
+    this.byDate.replace(previous, entry);
+    this.byPopularity.replace(previous, entry);
+    this.authorIndex(post.authorId).replace(previous, entry);
+
+    if (changes.title !== undefined || changes.content !== undefined || changes.author) {
+      this.searchIndex.add(id, searchableText(post));
+    }
+    this.changeLog.upserted(id);
+    return entry;
+  }
+
+  private authorIndex(authorId: string): SortedIndex<PostEntry> {
+    let index = this.byAuthor.get(authorId);
+    if (!index) {
+      index = new SortedIndex(compareByDate);
+      this.byAuthor.set(authorId, index);
+    }
+    return index;
+  }
+
+  private record(operation: PostOperation): void {
+    this.log?.append(operation);
+    for (let i = 0; i < this.listeners.length; i++) {
+      this.listeners[i](operation);
+    }
+  }
+
+  private unindex(entry: PostEntry): void {
+    this.byDate.remove(entry);
+    this.byPopularity.remove(entry);
+
+    const authorIndex = this.byAuthor.get(entry.post.authorId);
+    if (authorIndex) {
+      authorIndex.remove(entry);
+      if (authorIndex.size === 0) {
+        this.byAuthor.delete(entry.post.authorId);
+      }
+    }
+  }
+}
+
+// The full post of an entry, with likedBy brought up to date. The rebuilt
+// post replaces the stale one, so a run of reads between likes pays once.
+function postOf(entry: PostEntry): Post {
+  if (entry.likedByStale && entry.likers) {
+    entry.post = { ...entry.post, likedBy: Array.from(entry.likers) };
+    entry.likedByStale = false;
+  }
+  return entry.post;
+}
+
+function searchableText(post: Post): string {
+  return `${post.title} ${post.content} ${post.author ? post.author.name : ''}`;
+}
+
+// Minimal entry that sorts at the position of `key` in either index
+function entryForKey(key: PostKey): PostEntry {
+  return { post: { id: key.id, likes: key.likes } as Post, time: key.time };
+}
+
+// Keep a single instance per server process. Next.js bundles every API route
+// separately and re-evaluates modules on hot reload, so a module-level
+// variable would give each route (and each reload) its own copy of the data.
+const globalForPosts = globalThis as typeof globalThis & {
+  __postRepository?: PostRepository;
+};
+
+// Posts are persisted under POSTS_DATA_DIR (default .data/) unless
+// POSTS_PERSISTENCE=off; tests always run in memory
+function createRepository(): PostRepository {
+  const repository = new PostRepository();
+  const persist = process.env.NODE_ENV !== 'test' && process.env.POSTS_PERSISTENCE !== 'off';
+  const dataDir = process.env.POSTS_DATA_DIR || path.join(process.cwd(), '.data');
+
+  if (!persist || !attachPersistence(repository, dataDir)) {
+    mockPosts.forEach(post => repository.insert(post));
+  }
+  return repository;
+}
+
+export function getPostRepository(): PostRepository {
+  if (!globalForPosts.__postRepository) {
+    globalForPosts.__postRepository = createRepository();
+  }
+  return globalForPosts.__postRepository;
+}
+
+// Swap the shared instance (used by tests and benchmarks to seed data)
+export function setPostRepository(repository: PostRepository): void {
+  globalForPosts.__postRepository = repository;
+}
@@ -0,0 +1,203 @@
+import type { NextApiHandler, NextApiRequest, NextApiResponse } from 'next';
+import { ApiResponse } from '@/types';
+
+// Admission control for the API routes: per-client token buckets, plus
+// priority load shedding that keeps reads fast when writes back up.
+//
+// Every client IP address has one bucket for reads and one for writes. A
+// bucket is two numbers refilled lazily on use, so tracking a client is O(1)
+// in time and memory; the least recently seen clients are forgotten past
+// `maxKeys` (a forgotten client starts again with a full bucket). A request
+// over its budget gets 429 with Retry-After. Clients are not keyed on the
+// X-User-Id header: it is unauthenticated, so a client could rotate it for
+// fresh budgets or spend another user's.
+//
+// Writes hold the event loop and the write-ahead log, so when
+// `maxPendingWrites` are already in flight new writes are refused with 503
+// instead of queueing behind them. Reads are never shed; their latency stays
+// flat however many writes are arriving.
+//
+// Requests without an address (in-process calls from tests and benchmarks)
+// have nothing to key on and are not limited.
+// RATE_LIMIT=off turns the per-client budgets off (for load tests, which
+// send everything from one address); shedding stays on.
+
+export interface BucketLimit {
+  capacity: number; // Burst size
+  refillPerSecond: number; // Sustained rate
+}
+
+interface Bucket {
+  tokens: number;
+  updatedAt: number;
+}
+
+// Token buckets by key, least recently used first
+export class TokenBuckets {
+  private buckets = new Map<string, Bucket>();
+  private readonly limit: BucketLimit;
+  private readonly maxKeys: number;
+  private readonly now: () => number;
+
+  constructor(limit: BucketLimit, maxKeys: number, now: () => number = Date.now) {
+    this.limit = limit;
+    this.maxKeys = maxKeys;
+    this.now = now;
+  }
+
+  get size(): number {
+    return this.buckets.size;
+  }
+
+  // Takes a token for `key`: 0 if one was available, otherwise the ms until
+  // one will be
+  take(key: string): number {
+    const { capacity, refillPerSecond } = this.limit;
+    const now = this.now();
+    let bucket = this.buckets.get(key);
+
+    if (bucket) {
+      // Re-inserted below, which moves the key to the recent end
+      this.buckets.delete(key);
+      const refilled = ((now - bucket.updatedAt) * refillPerSecond) / 1000;
+      bucket.tokens = Math.min(capacity, bucket.tokens + refilled);
+      bucket.updatedAt = now;
+    } else {
+      bucket = { tokens: capacity, updatedAt: now };
+      if (this.buckets.size >= this.maxKeys) {
+        this.buckets.delete(this.buckets.keys().next().value as string);
+      }
+    }
+    this.buckets.set(key, bucket);
+
+    if (bucket.tokens >= 1) {
+      bucket.tokens -= 1;
+      return 0;
+    }
+    return Math.ceil(((1 - bucket.tokens) * 1000) / refillPerSecond);
+  }
+}
+
+export interface RateLimitOptions {
+  read?: BucketLimit;
+  write?: BucketLimit;
+  maxKeys?: number; // Clients tracked per bucket kind
+  maxPendingWrites?: number;
+  trustProxy?: boolean; // Take the client address from X-Forwarded-For
+  clientLimits?: boolean; // Default true; false only sheds writes
+  now?: () => number;
+}
+
+export interface Rejection {
+  status: 429 | 503;
+  retryAfter: number; // Seconds
+  error: string;
+}
+
+const READ_METHODS = ['GET', 'HEAD', 'OPTIONS'];
+
+export class RateLimiter {
+  private readonly reads: TokenBuckets;
+  private readonly writes: TokenBuckets;
+  private readonly maxPendingWrites: number;
+  private readonly trustProxy: boolean;
+  private readonly clientLimits: boolean;
+  private pending = 0;
+
+  constructor(options: RateLimitOptions = {}) {
+    const maxKeys = options.maxKeys || 10000;
+    this.reads = new TokenBuckets(options.read || { capacity: 200, refillPerSecond: 50 }, maxKeys, options.now);
+    this.writes = new TokenBuckets(options.write || { capacity: 30, refillPerSecond: 5 }, maxKeys, options.now);
+    this.maxPendingWrites = options.maxPendingWrites || 256;
+    this.trustProxy = !!options.trustProxy;
+    this.clientLimits = options.clientLimits !== false;
+  }
+
+  get pendingWrites(): number {
+    return this.pending;
+  }
+
+  // Key for the client sending `req` (null when it cannot be identified)
+  clientKey(req: NextApiRequest): string | null {
+    const forwarded = this.trustProxy ? req.headers['x-forwarded-for'] : undefined;
+    const ip = forwarded
+      ? (Array.isArray(forwarded) ? forwarded[0] : forwarded).split(',')[0].trim()
+      : req.socket && req.socket.remoteAddress;
+    return ip ? `ip:${ip}` : null;
+  }
+
+  // Null when the request may proceed
+  admit(req: NextApiRequest, write: boolean): Rejection | null {
+    if (write && this.pending >= this.maxPendingWrites) {
+      return { status: 503, retryAfter: 1, error: 'Server is busy; retry shortly' };
+    }
+
+    if (!this.clientLimits) {
+      return null;
+    }
+
+    const key = this.clientKey(req);
+    const wait = key ? (write ? this.writes : this.reads).take(key) : 0;
+    if (wait > 0) {
+      return { status: 429, retryAfter: Math.ceil(wait / 1000), error: 'Too many requests' };
+    }
+    return null;
+  }
+
+  // Counts a write as pending until `result` settles
+  trackWrite(result: unknown): void {
+    const release = () => {
+      this.pending--;
+    };
+    this.pending++;
+    if (result && typeof (result as Promise<unknown>).then === 'function') {
+      (result as Promise<unknown>).then(release, release);
+    } else {
+      release();
+    }
+  }
+}
+
+const globalForRateLimit = globalThis as typeof globalThis & {
+  __rateLimiter?: RateLimiter;
+};
+
+export function getRateLimiter(): RateLimiter {
+  if (!globalForRateLimit.__rateLimiter) {
+    globalForRateLimit.__rateLimiter = new RateLimiter({
+      trustProxy: process.env.TRUST_PROXY === '1',
+      clientLimits: process.env.RATE_LIMIT !== 'off',
+    });
+  }
+  return globalForRateLimit.__rateLimiter;
+}
+
+// Swap the shared instance (used by tests to set small limits)
+export function setRateLimiter(limiter: RateLimiter): void {
+  globalForRateLimit.__rateLimiter = limiter;
+}
+
+// Wraps an API route in admission control. GET/HEAD/OPTIONS are reads and
+// everything else a write, unless the route is `readOnly` (e.g. a POST that
+// only looks posts up). The handler itself still runs synchronously.
+export function withRateLimit<T>(handler: NextApiHandler<T>, options: { readOnly?: boolean } = {}): NextApiHandler<T> {
+  return (req, res) => {
+    const limiter = getRateLimiter();
+    const write = !options.readOnly && READ_METHODS.indexOf(req.method || 'GET') === -1;
+    const rejection = limiter.admit(req, write);
+
+    if (rejection) {
+      res.setHeader('Retry-After', String(rejection.retryAfter));
+      return (res as NextApiResponse<ApiResponse<never>>).status(rejection.status).json({
+        success: false,
+        error: rejection.error,
+      });
+    }
+
+    const result = handler(req, res);
+    if (write) {
+      limiter.trackWrite(result);
+    }
+    return result;
+  };
+}
@@ -0,0 +1,419 @@
+import type { IncomingMessage, Server as HttpServer } from 'http';
+import type { Duplex } from 'stream';
+import { WebSocketServer } from 'ws';
+import {
+  ClientMessage,
+  CommentAddedPayload,
+  TypingPayload,
+  WebSocketMessage,
+  WebSocketMessageType,
+} from '@/types/websocket';
+import { PostOperation, PostRepository } from './postRepository';
+
+// Realtime gateway: pushes post mutations to WebSocket clients by topic.
+//
+// - Each event is serialized once into a Buffer and that same Buffer is
+//   handed to every subscriber's socket. Server frames are unmasked, so ws
+//   writes the payload as-is (no per-client copy or re-encoding).
+// - Each connection has a byte budget for writes the socket has not flushed
+//   yet. Past it, events wait in a bounded per-connection queue where a newer
+//   event for the same post replaces the older one (likes collapse to the
+//   latest count). The replacement goes to the back of the queue, so frames
+//   always leave in `seq` order. If the queue still overflows, the oldest
+//   events are dropped and the client is told to RESYNC via
+//   /api/posts/changes.
+// - Server pings detect dead peers; clients can also send an app-level PING.
+// - Client frames are small control messages, capped at MAX_PAYLOAD_BYTES.
+//   Typing and comment messages are relayed with whitelisted, size-checked
+//   fields only.
+
+export const REALTIME_PATH = '/api/realtime';
+export const FEED_TOPIC = 'feed';
+export const PRESENCE_TOPIC = 'presence';
+
+const MAX_QUEUED_MESSAGES = 256;
+// Bytes handed to a socket but not yet written out, per connection
+const MAX_INFLIGHT_BYTES = 256 * 1024;
+const HEARTBEAT_INTERVAL_MS = 30 * 1000;
+const MAX_TOPICS_PER_CONNECTION = 1000;
+// Largest frame a client may send (ws defaults to 100 MiB)
+const MAX_PAYLOAD_BYTES = 8 * 1024;
+const MAX_ID_LENGTH = 64;
+const MAX_COMMENT_LENGTH = 1000;
+
+export const postTopic = (id: string) => `post:${id}`;
+
+const isId = (value: unknown): value is string =>
+  typeof value === 'string' && value.length > 0 && value.length <= MAX_ID_LENGTH;
+
+// What other subscribers get from a client's typing or comment message, or
+// null when it is malformed. Fields outside the payload types are dropped.
+function relayPayload(type: 'USER_TYPING' | 'COMMENT_ADDED', raw: unknown): TypingPayload | CommentAddedPayload | null {
+  const payload = (raw && typeof raw === 'object' ? raw : {}) as Record<string, unknown>;
+  const { postId } = payload;
+  if (!isId(postId)) {
+    return null;
+  }
+  if (type === 'USER_TYPING') {
+    return { postId, typing: payload.typing !== false };
+  }
+  const { commentId, content } = payload;
+  if (!isId(commentId) || typeof content !== 'string' || !content.trim() || content.length > MAX_COMMENT_LENGTH) {
+    return null;
+  }
+  return { postId, commentId, content };
+}
+
+// The subset of a ws WebSocket the gateway uses (lets tests pass fakes)
+export interface RealtimeSocket {
+  send(data: Buffer, options: { binary: boolean }, callback: (error?: Error) => void): void;
+  on(event: 'message', listener: (data: Buffer | ArrayBuffer | Buffer[]) => void): unknown;
+  on(event: 'close' | 'pong', listener: () => void): unknown;
+  ping(): void;
+  terminate(): void;
+}
+
+export interface GatewayStats {
+  connections: number;
+  published: number;
+  delivered: number;
+  coalesced: number;
+  dropped: number;
+}
+
+class Connection {
+  readonly topics = new Set<string>();
+  alive = true;
+  private inflightBytes = 0;
+  // Waiting events in send order, keyed for coalescing
+  private queue = new Map<string, Buffer>();
+  private lagged = false;
+  private closed = false;
+  private unkeyed = 0;
+
+  constructor(
+    readonly socket: RealtimeSocket,
+    readonly userId: string,
+    private readonly gateway: RealtimeGateway
+  ) {}
+
+  // `key` identifies events that supersede each other; null never coalesces
+  send(frame: Buffer, key: string | null): void {
+    if (this.closed) {
+      return;
+    }
+    if (this.queue.size === 0 && this.inflightBytes < MAX_INFLIGHT_BYTES) {
+      this.write(frame);
+      return;
+    }
+
+    const stats = this.gateway.stats;
+    if (key !== null && this.queue.delete(key)) {
+      // The newer event takes the back of the queue rather than the old
+      // slot: a like must not overtake an update queued after the old like
+      stats.coalesced++;
+    }
+    this.queue.set(key === null ? `#${++this.unkeyed}` : key, frame);
+
+    if (this.queue.size > MAX_QUEUED_MESSAGES) {
+      const oldest = this.queue.keys().next().value as string;
+      this.queue.delete(oldest);
+      stats.dropped++;
+      this.lagged = true;
+    }
+  }
+
+  close(): void {
+    this.closed = true;
+    this.queue.clear();
+  }
+
+  private write(frame: Buffer): void {
+    this.inflightBytes += frame.length;
+    this.gateway.stats.delivered++;
+    this.socket.send(frame, { binary: false }, () => {
+      this.inflightBytes -= frame.length;
+      this.drain();
+    });
+  }
+
+  private drain(): void {
+    while (this.queue.size > 0 && this.inflightBytes < MAX_INFLIGHT_BYTES && !this.closed) {
+      const key = this.queue.keys().next().value as string;
+      const frame = this.queue.get(key) as Buffer;
+      this.queue.delete(key);
+      this.write(frame);
+    }
+
+    // Caught up after dropping events: the client must fill the gap itself
+    if (this.lagged && this.queue.size === 0 && !this.closed) {
+      this.lagged = false;
+      this.write(this.gateway.frame('RESYNC', {}, ''));
+    }
+  }
+}
+
+export class RealtimeGateway {
+  readonly stats: GatewayStats = { connections: 0, published: 0, delivered: 0, coalesced: 0, dropped: 0 };
+  private topics = new Map<string, Set<Connection>>();
+  private connections = new Set<Connection>();
+  private seq = 0;
+  private heartbeat: ReturnType<typeof setInterval> | null = null;
+  // Distinguishes server runs in message ids
+  private readonly epoch = Date.now().toString(36);
+
+  // Publish every write made to `repository`
+  watch(repository: PostRepository): () => void {
+    return repository.subscribe(operation => this.publishOperation(repository, operation));
+  }
+
+  connect(socket: RealtimeSocket, userId: string): void {
+    const connection = new Connection(socket, userId, this);
+    this.connections.add(connection);
+    this.stats.connections = this.connections.size;
+    this.startHeartbeat();
+
+    socket.on('pong', () => {
+      connection.alive = true;
+    });
+    socket.on('message', data => this.receive(connection, data));
+    socket.on('close', () => this.disconnect(connection));
+
+    this.publish([PRESENCE_TOPIC], 'USER_PRESENCE', { online: true }, userId, `presence:${userId}`);
+  }
+
+  // Serialize once, then fan out to every connection subscribed to any of
+  // `topics` (each connection at most once)
+  publish(
+    topics: string[],
+    type: WebSocketMessageType,
+    payload: unknown,
+    userId: string,
+    coalesceKey: string | null = null,
+    except?: Connection
+  ): void {
+    const frame = this.frame(type, payload, userId);
+    this.stats.published++;
+
+    let delivered: Set<Connection> | null = null;
+    for (let i = 0; i < topics.length; i++) {
+      const subscribers = this.topics.get(topics[i]);
+      if (!subscribers) {
+        continue;
+      }
+      subscribers.forEach(connection => {
+        if (connection === except || (delivered && delivered.has(connection))) {
+          return;
+        }
+        connection.send(frame, coalesceKey);
+        if (topics.length > 1) {
+          (delivered || (delivered = new Set())).add(connection);
+        }
+      });
+    }
+  }
+
+  frame(type: WebSocketMessageType, payload: unknown, userId: string): Buffer {
+    const seq = ++this.seq;
+    const message: WebSocketMessage = {
+      type,
+      payload,
+      timestamp: Date.now(),
+      messageId: `${this.epoch}-${seq}`,
+      userId,
+      seq,
+    };
+    return Buffer.from(JSON.stringify(message));
+  }
+
+  subscriberCount(topic: string): number {
+    const subscribers = this.topics.get(topic);
+    return subscribers ? subscribers.size : 0;
+  }
+
+  close(): void {
+    this.connections.forEach(connection => {
+      connection.socket.terminate();
+      this.disconnect(connection);
+    });
+    if (this.heartbeat) {
+      clearInterval(this.heartbeat);
+      this.heartbeat = null;
+    }
+  }
+
+  // Post events carry the store version they produced, which clients keep
+  // as their /api/posts/changes cursor for when they need to RESYNC
+  private publishOperation(repository: PostRepository, operation: PostOperation): void {
+    const { epoch, version } = repository;
+    switch (operation.op) {
+      case 'insert':
+        this.publish([FEED_TOPIC], 'POST_CREATED', { post: operation.post, epoch, version }, operation.post.authorId);
+        break;
+      case 'update': {
+        const post = repository.get(operation.id);
+        if (post) {
+          const topics = [FEED_TOPIC, postTopic(post.id)];
+          this.publish(topics, 'POST_UPDATED', { post, epoch, version }, post.authorId, `post:${post.id}`);
+        }
+        break;
+      }
+      case 'like': {
+        // Just the count: building the full post would cost O(likers) per like
+        const likes = repository.likeCount(operation.id);
+        if (likes !== undefined) {
+          const topics = [FEED_TOPIC, postTopic(operation.id)];
+          const payload = { postId: operation.id, likes, liked: operation.liked, epoch, version };
+          this.publish(topics, 'POST_LIKED', payload, operation.userId, `likes:${operation.id}`);
+        }
+        break;
+      }
+      case 'delete':
+        // Shares the update key: a delete supersedes a queued update
+        this.publish(
+          [FEED_TOPIC, postTopic(operation.id)],
+          'POST_DELETED',
+          { postId: operation.id, epoch, version },
+          '',
+          `post:${operation.id}`
+        );
+        break;
+    }
+  }
+
+  private receive(connection: Connection, data: Buffer | ArrayBuffer | Buffer[]): void {
+    let message: ClientMessage;
+    try {
+      const text = Array.isArray(data)
+        ? Buffer.concat(data).toString()
+        : Buffer.isBuffer(data)
+          ? data.toString()
+          : Buffer.from(data).toString();
+      message = JSON.parse(text);
+    } catch (error) {
+      return;
+    }
+    if (!message || typeof message !== 'object') {
+      return;
+    }
+
+    switch (message.type) {
+      case 'SUBSCRIBE':
+        (message.topics || []).forEach(topic => {
+          if (typeof topic === 'string' && connection.topics.size < MAX_TOPICS_PER_CONNECTION) {
+            this.join(connection, topic);
+          }
+        });
+        break;
+      case 'UNSUBSCRIBE':
+        (message.topics || []).forEach(topic => this.leave(connection, topic));
+        break;
+      case 'PING':
+        connection.send(this.frame('PONG', { id: message.id }, ''), null);
+        break;
+      case 'USER_TYPING':
+      case 'COMMENT_ADDED': {
+        const payload = relayPayload(message.type, message.payload);
+        if (payload) {
+          const { postId } = payload;
+          const key = message.type === 'USER_TYPING' ? `typing:${postId}:${connection.userId}` : null;
+          this.publish([postTopic(postId)], message.type, payload, connection.userId, key, connection);
+        }
+        break;
+      }
+    }
+  }
+
+  private join(connection: Connection, topic: string): void {
+    let subscribers = this.topics.get(topic);
+    if (!subscribers) {
+      subscribers = new Set();
+      this.topics.set(topic, subscribers);
+    }
+    subscribers.add(connection);
+    connection.topics.add(topic);
+  }
+
+  private leave(connection: Connection, topic: string): void {
+    const subscribers = this.topics.get(topic);
+    if (subscribers) {
+      subscribers.delete(connection);
+      if (subscribers.size === 0) {
+        this.topics.delete(topic);
+      }
+    }
+    connection.topics.delete(topic);
+  }
+
+  private disconnect(connection: Connection): void {
+    if (!this.connections.delete(connection)) {
+      return;
+    }
+    connection.close();
+    Array.from(connection.topics).forEach(topic => this.leave(connection, topic));
+    this.stats.connections = this.connections.size;
+    this.publish([PRESENCE_TOPIC], 'USER_PRESENCE', { online: false }, connection.userId, `presence:${connection.userId}`);
+  }
+
+  private startHeartbeat(): void {
+    if (this.heartbeat) {
+      return;
+    }
+    const timer = setInterval(() => {
+      this.connections.forEach(connection => {
+        if (!connection.alive) {
+          connection.socket.terminate();
+          this.disconnect(connection);
+          return;
+        }
+        connection.alive = false;
+        connection.socket.ping();
+      });
+    }, HEARTBEAT_INTERVAL_MS);
+    // Never keep the process alive just for heartbeats
+    if (timer.unref) {
+      timer.unref();
+    }
+    this.heartbeat = timer;
+  }
+}
+
+// One gateway per server process, for the same reason as the repository
+// singleton (Next.js bundles routes separately and reloads them)
+const globalForRealtime = globalThis as typeof globalThis & {
+  __realtimeGateway?: RealtimeGateway;
+  __realtimeServers?: WeakSet<HttpServer>;
+};
+
+export function getRealtimeGateway(repository: PostRepository): RealtimeGateway {
+  if (!globalForRealtime.__realtimeGateway) {
+    const gateway = new RealtimeGateway();
+    gateway.watch(repository);
+    globalForRealtime.__realtimeGateway = gateway;
+  }
+  return globalForRealtime.__realtimeGateway;
+}
+
+// Route WebSocket upgrades for REALTIME_PATH on `server` to the gateway.
+// Other upgrades (e.g. Next.js hot reload) are left alone. Idempotent.
+export function attachRealtime(server: HttpServer, gateway: RealtimeGateway): void {
+  const servers = globalForRealtime.__realtimeServers || (globalForRealtime.__realtimeServers = new WeakSet());
+  if (servers.has(server)) {
+    return;
+  }
+  servers.add(server);
+
+  // Compression would re-encode every frame per client, defeating the
+  // single shared payload
+  const wss = new WebSocketServer({ noServer: true, perMessageDeflate: false, maxPayload: MAX_PAYLOAD_BYTES });
+
+  server.on('upgrade', (req: IncomingMessage, socket: Duplex, head: Buffer) => {
+    const url = new URL(req.url || '/', 'http://localhost');
+    if (url.pathname !== REALTIME_PATH) {
+      return;
+    }
+    wss.handleUpgrade(req, socket, head, ws => {
+      gateway.connect(ws as unknown as RealtimeSocket, url.searchParams.get('userId') || 'anonymous');
+    });
+  });
+}
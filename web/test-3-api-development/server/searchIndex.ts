@@ -0,0 +1,157 @@
+import { SortedIndex } from './sortedIndex';
+
+// Inverted index for full-text post search.
+//
+// Every document is tokenized once when it is added; queries then only touch
+// the posting lists of their terms instead of scanning every string. The
+// term dictionary is kept sorted so the last query token can be matched as a
+// prefix (search-as-you-type).
+
+const compareTerms = (a: string, b: string) => (a < b ? -1 : a > b ? 1 : 0);
+
+// Runs of Unicode letters and digits, so non-Latin text is searchable too.
+// Built with the constructor because the target (es5) has no regex literal
+// `u` flag.
+const SEPARATORS = new RegExp('[^\\p{L}\\p{N}]+', 'u');
+
+export function tokenize(text: string): string[] {
+  return text.toLowerCase().split(SEPARATORS).filter(token => token.length > 0);
+}
+
+export class SearchIndex {
+  private postings = new Map<string, Set<string>>();
+  private terms = new SortedIndex<string>(compareTerms);
+  private documents = new Map<string, string[]>();
+
+  get size(): number {
+    return this.documents.size;
+  }
+
+  add(id: string, text: string): void {
+    if (this.documents.has(id)) {
+      this.remove(id);
+    }
+
+    const tokens = unique(tokenize(text));
+    this.documents.set(id, tokens);
+
+    tokens.forEach(token => {
+      let ids = this.postings.get(token);
+      if (!ids) {
+        ids = new Set();
+        this.postings.set(token, ids);
+        this.terms.insert(token);
+      }
+      ids.add(id);
+    });
+  }
+
+  remove(id: string): void {
+    const tokens = this.documents.get(id);
+    if (!tokens) {
+      return;
+    }
+
+    this.documents.delete(id);
+    tokens.forEach(token => {
+      const ids = this.postings.get(token);
+      if (!ids) {
+        return;
+      }
+      ids.delete(id);
+      if (ids.size === 0) {
+        this.postings.delete(token);
+        this.terms.remove(token);
+      }
+    });
+  }
+
+  // Ids of documents containing every query token; the last token also
+  // matches any term it is a prefix of. Returns null for a query without
+  // tokens (empty, or only punctuation).
+  // The result may be a live posting list, so callers must not keep it.
+  search(query: string): ReadonlySet<string> | null {
+    const tokens = unique(tokenize(query));
+    if (tokens.length === 0) {
+      return null;
+    }
+
+    const prefix = tokens.pop() as string;
+    const sets: Set<string>[] = [];
+
+    for (let i = 0; i < tokens.length; i++) {
+      const ids = this.postings.get(tokens[i]);
+      if (!ids) {
+        return new Set();
+      }
+      sets.push(ids);
+    }
+
+    // Intersect the exact terms first (smallest list drives the loop) so a
+    // short prefix with huge postings only needs to be probed, not unioned
+    if (sets.length > 0) {
+      sets.sort((a, b) => a.size - b.size);
+      const narrowed = new Set<string>();
+      intersect(sets).forEach(id => {
+        const docTokens = this.documents.get(id) as string[];
+        if (docTokens.some(token => token.startsWith(prefix))) {
+          narrowed.add(id);
+        }
+      });
+      return narrowed;
+    }
+
+    const terms = this.termsWithPrefix(prefix);
+    if (terms.length === 1) {
+      return this.postings.get(terms[0]) as Set<string>;
+    }
+
+    const result = new Set<string>();
+    terms.forEach(term => {
+      (this.postings.get(term) as Set<string>).forEach(id => result.add(id));
+    });
+    return result;
+  }
+
+  private termsWithPrefix(prefix: string): string[] {
+    const matches: string[] = [];
+    if (this.postings.has(prefix)) {
+      matches.push(prefix);
+    }
+
+    // seek() starts strictly after `prefix`, which is exactly where longer
+    // terms sharing the prefix begin
+    this.terms.forEachFrom(this.terms.seek('asc', prefix), 'asc', term => {
+      if (!term.startsWith(prefix)) {
+        return false;
+      }
+      matches.push(term);
+    });
+    return matches;
+  }
+}
+
+function unique(tokens: string[]): string[] {
+  const seen = new Set<string>();
+  return tokens.filter(token => {
+    if (seen.has(token)) {
+      return false;
+    }
+    seen.add(token);
+    return true;
+  });
+}
+
+function intersect(sets: Set<string>[]): Set<string> {
+  const [smallest, ...rest] = sets;
+  const result = new Set<string>();
+  smallest.forEach(id => {
+    for (let i = 0; i < rest.length; i++) {
+      if (!rest[i].has(id)) {
+        return;
+      }
+    }
+    result.add(id);
+  });
+  return result;
+}
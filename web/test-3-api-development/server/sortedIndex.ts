@@ -0,0 +1,223 @@
+// Sorted collection used for the secondary indexes of the post repository.
+//
+// Values are kept in a list of sorted blocks. Lookups binary-search the block
+// list and then the block, and inserts/removals only splice inside a single
+// block, so the cost is O(log n + BLOCK_SIZE) instead of the O(n) shift of
+// one flat array.
+
+const BLOCK_SIZE = 512;
+
+export type Comparator<T> = (a: T, b: T) => number;
+
+// Position of a value inside the index (block number + offset in the block)
+export interface IndexPosition {
+  block: number;
+  offset: number;
+}
+
+export type IndexDirection = 'asc' | 'desc';
+
+export class SortedIndex<T> {
+  private blocks: T[][] = [];
+  private count = 0;
+
+  constructor(private readonly compare: Comparator<T>) {}
+
+  get size(): number {
+    return this.count;
+  }
+
+  insert(value: T): void {
+    if (this.blocks.length === 0) {
+      this.blocks.push([value]);
+      this.count = 1;
+      return;
+    }
+
+    const blockIndex = this.findBlock(value);
+    const block = this.blocks[blockIndex];
+    block.splice(this.lowerBound(block, value), 0, value);
+    this.count++;
+
+    // Split oversized blocks so splices stay cheap
+    if (block.length > BLOCK_SIZE * 2) {
+      this.blocks.splice(blockIndex + 1, 0, block.splice(BLOCK_SIZE));
+    }
+  }
+
+  remove(value: T): boolean {
+    const position = this.find(value);
+    if (!position) {
+      return false;
+    }
+
+    const block = this.blocks[position.block];
+    block.splice(position.offset, 1);
+    this.count--;
+
+    if (block.length === 0) {
+      this.blocks.splice(position.block, 1);
+    }
+    return true;
+  }
+
+  // Swap a value for one that sorts identically without moving anything,
+  // otherwise fall back to remove + insert
+  replace(previous: T, next: T): void {
+    if (this.compare(previous, next) === 0) {
+      const position = this.find(previous);
+      if (position) {
+        this.blocks[position.block][position.offset] = next;
+        return;
+      }
+    } else {
+      this.remove(previous);
+    }
+    this.insert(next);
+  }
+
+  // Exact position of a value, or null when it is not in the index
+  find(value: T): IndexPosition | null {
+    if (this.count === 0) {
+      return null;
+    }
+
+    const blockIndex = this.findBlock(value);
+    const block = this.blocks[blockIndex];
+    const offset = this.lowerBound(block, value);
+
+    if (offset >= block.length || this.compare(block[offset], value) !== 0) {
+      return null;
+    }
+    return { block: blockIndex, offset };
+  }
+
+  // Position where iteration in the given direction should start so that
+  // every visited value sorts strictly after `value` in that direction.
+  // Pass no value to start from the first element of the direction.
+  seek(direction: IndexDirection, value?: T): IndexPosition | null {
+    if (this.count === 0) {
+      return null;
+    }
+
+    if (value === undefined) {
+      if (direction === 'asc') {
+        return { block: 0, offset: 0 };
+      }
+      const last = this.blocks.length - 1;
+      return { block: last, offset: this.blocks[last].length - 1 };
+    }
+
+    if (direction === 'asc') {
+      const blockIndex = this.findBlock(value, true);
+      const block = this.blocks[blockIndex];
+      const offset = this.upperBound(block, value);
+      return this.normalize(blockIndex, offset);
+    }
+
+    const blockIndex = this.findBlock(value);
+    const offset = this.lowerBound(this.blocks[blockIndex], value) - 1;
+    return this.normalize(blockIndex, offset);
+  }
+
+  // Visit values starting at `start`, stopping early when `visit` returns false
+  forEachFrom(
+    start: IndexPosition | null,
+    direction: IndexDirection,
+    visit: (value: T) => boolean | void
+  ): void {
+    if (!start) {
+      return;
+    }
+
+    const step = direction === 'asc' ? 1 : -1;
+    let blockIndex = start.block;
+    let offset = start.offset;
+
+    while (blockIndex >= 0 && blockIndex < this.blocks.length) {
+      const block = this.blocks[blockIndex];
+      while (offset >= 0 && offset < block.length) {
+        if (visit(block[offset]) === false) {
+          return;
+        }
+        offset += step;
+      }
+
+      blockIndex += step;
+      if (blockIndex >= 0 && blockIndex < this.blocks.length) {
+        offset = step === 1 ? 0 : this.blocks[blockIndex].length - 1;
+      }
+    }
+  }
+
+  forEach(direction: IndexDirection, visit: (value: T) => boolean | void): void {
+    this.forEachFrom(this.seek(direction), direction, visit);
+  }
+
+  // Index of the block that should hold `value`: the first block whose last
+  // element is >= value (or > value when `strict`), clamped to the last block
+  private findBlock(value: T, strict = false): number {
+    let low = 0;
+    let high = this.blocks.length - 1;
+
+    while (low < high) {
+      const mid = (low + high) >>> 1;
+      const block = this.blocks[mid];
+      const cmp = this.compare(block[block.length - 1], value);
+      if (cmp < 0 || (strict && cmp === 0)) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    return low;
+  }
+
+  private lowerBound(block: T[], value: T): number {
+    let low = 0;
+    let high = block.length;
+    while (low < high) {
+      const mid = (low + high) >>> 1;
+      if (this.compare(block[mid], value) < 0) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    return low;
+  }
+
+  private upperBound(block: T[], value: T): number {
+    let low = 0;
+    let high = block.length;
+    while (low < high) {
+      const mid = (low + high) >>> 1;
+      if (this.compare(block[mid], value) <= 0) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    return low;
+  }
+
+  // Move an offset that ran past either end of its block onto the neighbour
+  private normalize(blockIndex: number, offset: number): IndexPosition | null {
+    if (offset < 0) {
+      if (blockIndex === 0) {
+        return null;
+      }
+      const previous = blockIndex - 1;
+      return { block: previous, offset: this.blocks[previous].length - 1 };
+    }
+
+    if (offset >= this.blocks[blockIndex].length) {
+      if (blockIndex === this.blocks.length - 1) {
+        return null;
+      }
+      return { block: blockIndex + 1, offset: 0 };
+    }
+
+    return { block: blockIndex, offset };
+  }
+}
@@ -0,0 +1,28 @@
+import type { ServerResponse } from 'http';
+
+// Backpressure-aware writes for streamed responses. `write` returns false
+// once the socket buffer is full; waiting for 'drain' before writing more
+// keeps server memory bounded by the buffer size instead of the payload.
+
+export function waitForDrain(res: ServerResponse): Promise<void> {
+  return new Promise(resolve => {
+    const done = () => {
+      res.off('drain', done);
+      res.off('close', done);
+      resolve();
+    };
+    res.on('drain', done);
+    res.on('close', done);
+  });
+}
+
+// Resolves once `chunk` is accepted; false when the client has gone away
+export async function writeChunk(res: ServerResponse, chunk: string): Promise<boolean> {
+  if (res.destroyed) {
+    return false;
+  }
+  if (!res.write(chunk)) {
+    await waitForDrain(res);
+  }
+  return !res.destroyed;
+}
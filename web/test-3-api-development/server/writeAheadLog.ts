@@ -0,0 +1,272 @@
+import fs, { promises as fsp } from 'fs';
+import type { FileHandle } from 'fs/promises';
+import path from 'path';
+import { StringDecoder } from 'string_decoder';
+
+// Append-only, segment-based write-ahead log with group commit.
+//
+// Records are NDJSON lines tagged with a log sequence number (lsn). Appends
+// are buffered and written + fdatasync'ed as one batch per commit, so
+// concurrent writers share a single fsync. A snapshot captures the state at
+// some lsn; segments older than the snapshot are then deleted.
+//
+// Layout of `dir`:
+//   snapshot.ndjson     {"lsn":N} header line, then one record per line
+//   wal-<startLsn>.log  segments, replayed in start order after the snapshot
+
+const SNAPSHOT_FILE = 'snapshot.ndjson';
+const READ_CHUNK_SIZE = 4 * 1024 * 1024;
+
+export interface LoggedRecord {
+  lsn: number;
+}
+
+export interface LoadResult {
+  lastLsn: number;
+  snapshotLsn: number;
+  snapshotRecords: number;
+  logRecords: number;
+}
+
+export class WriteAheadLog<T extends object> {
+  private handle: FileHandle | null = null;
+  private segments: { start: number; file: string }[] = [];
+  private lastLsn = 0;
+
+  // Lines appended since the last commit was queued, and that commit
+  private batch: string[] | null = null;
+  private batchCommit: Promise<void> | null = null;
+  // Serializes every file operation (commits, rotations)
+  private chain: Promise<void> = Promise.resolve();
+
+  constructor(private readonly dir: string) {}
+
+  get lsn(): number {
+    return this.lastLsn;
+  }
+
+  // Synchronously load the snapshot and replay newer segments (startup only).
+  // `onSnapshot` receives snapshot records, `onRecord` newer log records.
+  load<S>(onSnapshot: (record: S) => void, onRecord: (record: T & LoggedRecord) => void): LoadResult {
+    fs.mkdirSync(this.dir, { recursive: true });
+
+    let snapshotLsn = 0;
+    let snapshotRecords = 0;
+    let logRecords = 0;
+    const snapshotPath = path.join(this.dir, SNAPSHOT_FILE);
+
+    if (fs.existsSync(snapshotPath)) {
+      let header = true;
+      readLines(snapshotPath, line => {
+        const value = JSON.parse(line);
+        if (header) {
+          snapshotLsn = value.lsn;
+          header = false;
+        } else {
+          onSnapshot(value);
+          snapshotRecords++;
+        }
+        return true;
+      });
+    }
+
+    this.lastLsn = snapshotLsn;
+    this.segments = listSegments(this.dir);
+
+    for (let i = 0; i < this.segments.length; i++) {
+      const file = path.join(this.dir, this.segments[i].file);
+      let intact = true;
+
+      const validBytes = readLines(file, line => {
+        let record: T & LoggedRecord;
+        try {
+          record = JSON.parse(line);
+        } catch (error) {
+          intact = false;
+          return false;
+        }
+        if (record.lsn > this.lastLsn) {
+          onRecord(record);
+          this.lastLsn = record.lsn;
+          logRecords++;
+        }
+        return true;
+      });
+
+      // A torn tail (crash mid-append) ends the log: cut it off so later
+      // segments or appends are never glued to a partial line
+      if (!intact || validBytes < fs.statSync(file).size) {
+        fs.truncateSync(file, validBytes);
+        this.segments.slice(i + 1).forEach(segment => {
+          fs.unlinkSync(path.join(this.dir, segment.file));
+        });
+        this.segments = this.segments.slice(0, i + 1);
+        break;
+      }
+    }
+
+    return { lastLsn: this.lastLsn, snapshotLsn, snapshotRecords, logRecords };
+  }
+
+  // Open a fresh segment for appends; call once after load(). Appends made
+  // before it resolves are queued behind it.
+  open(): Promise<void> {
+    const start = this.lastLsn + 1;
+    return this.enqueue(() => this.openSegment(start));
+  }
+
+  // Buffer a record; it is written by the next group commit. Returns its lsn.
+  append(record: T): number {
+    const lsn = ++this.lastLsn;
+    const line = JSON.stringify({ ...record, lsn }) + '\n';
+
+    if (!this.batch) {
+      const lines: string[] = [];
+      this.batch = lines;
+      this.batchCommit = this.enqueue(() => {
+        // Appends from here on start the next batch
+        if (this.batch === lines) {
+          this.batch = null;
+          this.batchCommit = null;
+        }
+        return this.writeBatch(lines);
+      });
+    }
+
+    this.batch.push(line);
+    return lsn;
+  }
+
+  // Resolves once every record appended so far is on disk
+  sync(): Promise<void> {
+    return this.batchCommit || this.chain;
+  }
+
+  // Start a new segment. Everything appended before the call stays in older
+  // segments, everything after goes to the new one. Resolves to the last lsn
+  // of the old segments.
+  rotate(): Promise<number> {
+    const lastLsn = this.lastLsn;
+    this.batch = null;
+    this.batchCommit = null;
+
+    return this.enqueue(() => this.openSegment(lastLsn + 1)).then(() => lastLsn);
+  }
+
+  // Atomically replace the snapshot with `records` (the state at `lsn`) and
+  // drop the segments it covers. Callers rotate() first to get `lsn`.
+  async writeSnapshot<S>(lsn: number, records: S[]): Promise<void> {
+    const finalPath = path.join(this.dir, SNAPSHOT_FILE);
+    const tempPath = `${finalPath}.tmp`;
+    const handle = await fsp.open(tempPath, 'w');
+
+    try {
+      await handle.write(JSON.stringify({ lsn }) + '\n');
+      for (let i = 0; i < records.length; i += 1000) {
+        const chunk = records.slice(i, i + 1000).map(record => JSON.stringify(record));
+        await handle.write(chunk.join('\n') + '\n');
+      }
+      await handle.datasync();
+    } finally {
+      await handle.close();
+    }
+
+    await fsp.rename(tempPath, finalPath);
+
+    const covered = this.segments.filter(segment => segment.start <= lsn);
+    this.segments = this.segments.filter(segment => segment.start > lsn);
+    await Promise.all(covered.map(segment => fsp.unlink(path.join(this.dir, segment.file))));
+  }
+
+  async close(): Promise<void> {
+    await this.sync();
+    await this.enqueue(async () => {
+      if (this.handle) {
+        await this.handle.close();
+        this.handle = null;
+      }
+    });
+  }
+
+  private enqueue<R>(task: () => Promise<R>): Promise<R> {
+    const result = this.chain.then(task);
+    // Keep the chain alive after a failure; the caller still sees the error
+    this.chain = result.then(
+      () => undefined,
+      error => {
+        console.error('Write-ahead log operation failed', error);
+      }
+    );
+    return result;
+  }
+
+  private async writeBatch(lines: string[]): Promise<void> {
+    if (!this.handle) {
+      throw new Error('Write-ahead log is not open');
+    }
+    await this.handle.write(lines.join(''));
+    await this.handle.datasync();
+  }
+
+  private async openSegment(start: number): Promise<void> {
+    if (this.handle) {
+      await this.handle.close();
+    }
+    const file = `wal-${start}.log`;
+    this.handle = await fsp.open(path.join(this.dir, file), 'a');
+    // An empty segment left by the previous run is simply reused
+    if (!this.segments.some(segment => segment.file === file)) {
+      this.segments.push({ start, file });
+    }
+  }
+}
+
+function listSegments(dir: string): { start: number; file: string }[] {
+  return fs
+    .readdirSync(dir)
+    .map(file => {
+      const match = /^wal-(\d+)\.log$/.exec(file);
+      return match ? { start: Number(match[1]), file } : null;
+    })
+    .filter((segment): segment is { start: number; file: string } => segment !== null)
+    .sort((a, b) => a.start - b.start);
+}
+
+// Read a file line by line in large chunks (much faster than readline for
+// millions of short lines). Stops when `visit` returns false. Returns the
+// number of bytes covered by complete, accepted lines.
+function readLines(file: string, visit: (line: string) => boolean): number {
+  const fd = fs.openSync(file, 'r');
+  const buffer = Buffer.alloc(READ_CHUNK_SIZE);
+  // Chunks can end mid-character; the decoder holds partial UTF-8 sequences
+  const decoder = new StringDecoder('utf8');
+  let carry = '';
+  let consumed = 0;
+
+  try {
+    for (;;) {
+      const bytesRead = fs.readSync(fd, buffer, 0, buffer.length, null);
+      if (bytesRead === 0) {
+        return consumed;
+      }
+
+      const text = carry + decoder.write(buffer.subarray(0, bytesRead));
+      let start = 0;
+      let newline = text.indexOf('\n', start);
+
+      while (newline !== -1) {
+        const line = text.slice(start, newline);
+        if (line.length > 0 && !visit(line)) {
+          return consumed;
+        }
+        consumed += Buffer.byteLength(line) + 1;
+        start = newline + 1;
+        newline = text.indexOf('\n', start);
+      }
+
+      carry = text.slice(start);
+    }
+  } finally {
+    fs.closeSync(fd);
+  }
+}
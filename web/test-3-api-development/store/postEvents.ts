@@ -0,0 +1,237 @@
+import { ApiResponse, Post, PostChangeSet, SyncCursor } from '@/types';
+import { PostEventVersion, WebSocketMessage, WebSocketMessageType } from '@/types/websocket';
+import { postsApi, responseCache } from '@/utils/api';
+import { RealtimeConnection } from '@/utils/websocket';
+import { usePostsStore } from './posts';
+
+// Feeds realtime post events into the posts store at most once per frame.
+//
+// A hot post can receive hundreds of likes a second; applying each as its
+// own set() would re-render its subscribers that many times. Events are
+// buffered instead, and on the next animation frame the whole buffer goes
+// to applyEvents(), which orders it, collapses it to one change per post
+// and commits it in a single set(). Render cost then follows the frame
+// rate, not the event rate.
+
+const POST_EVENTS = ['POST_CREATED', 'POST_UPDATED', 'POST_LIKED', 'POST_DELETED'];
+
+type Schedule = (flush: () => void) => void;
+
+// requestAnimationFrame does not run in hidden tabs; the buffer just waits
+// for the tab to come back. Outside the browser, fall back to a timer.
+const nextFrame: Schedule = flush => {
+  if (typeof window !== 'undefined' && window.requestAnimationFrame) {
+    window.requestAnimationFrame(() => flush());
+  } else {
+    setTimeout(flush, 16);
+  }
+};
+
+export class PostEventBuffer {
+  readonly stats = { received: 0, flushes: 0 };
+  private buffer: WebSocketMessage[] = [];
+  private scheduled = false;
+
+  constructor(
+    private readonly apply: (events: WebSocketMessage[]) => void = events =>
+      usePostsStore.getState().applyEvents(events),
+    private readonly schedule: Schedule = nextFrame
+  ) {}
+
+  get pending(): number {
+    return this.buffer.length;
+  }
+
+  push(event: WebSocketMessage): void {
+    if (POST_EVENTS.indexOf(event.type) === -1) {
+      return;
+    }
+    this.stats.received++;
+    this.buffer.push(event);
+    if (!this.scheduled) {
+      this.scheduled = true;
+      this.schedule(() => this.flush());
+    }
+  }
+
+  flush(): void {
+    this.scheduled = false;
+    if (this.buffer.length === 0) {
+      return;
+    }
+    const events = this.buffer;
+    this.buffer = [];
+    this.stats.flushes++;
+    this.apply(events);
+  }
+}
+
+// Never a real server run, so the changes endpoint answers with just its
+// current version (a baseline for a client that has no cursor yet)
+const NO_EPOCH = 'none';
+
+type FetchChanges = (since: number, epoch: string) => Promise<ApiResponse<PostChangeSet>>;
+
+// The feed as the server has it now; cached listings predate the reset
+function refetchFeed(): Promise<void> {
+  responseCache.invalidate('/api/posts');
+  return usePostsStore.getState().fetchPosts();
+}
+
+// Catches the store up on events the socket never delivered: frames the
+// gateway dropped under backpressure (it then sends RESYNC), and everything
+// published while the connection was down or suspended for a hidden tab.
+// The missed changes come from /api/posts/changes and are fed to the event
+// buffer as ordinary post events, so they are applied exactly like live ones.
+export class PostsResync {
+  private cursor: SyncCursor | null = null;
+  private running: Promise<void> | null = null;
+  private again = false;
+  private run = 0;
+
+  constructor(
+    private readonly buffer: PostEventBuffer,
+    private readonly fetchChanges: FetchChanges = (since, epoch) => postsApi.getChanges(since, epoch),
+    private readonly refetch: () => unknown = refetchFeed
+  ) {}
+
+  // Where this client is in the server's change history: the store version
+  // of the last post event it received, or of the last delta sync
+  get position(): SyncCursor | null {
+    return this.cursor;
+  }
+
+  // Start from the version the loaded posts were read at (server rendering),
+  // so the first sync fetches what changed since instead of a baseline
+  seed(cursor: SyncCursor): void {
+    if (!this.cursor) {
+      this.cursor = { epoch: cursor.epoch, version: cursor.version };
+    }
+  }
+
+  // Advance the cursor past a live event
+  observe(event: WebSocketMessage): void {
+    const { epoch, version } = (event.payload || {}) as PostEventVersion;
+    if (typeof epoch !== 'string' || typeof version !== 'number') {
+      return;
+    }
+    if (!this.cursor) {
+      this.cursor = { epoch, version };
+    } else if (this.cursor.epoch === epoch && version > this.cursor.version) {
+      this.cursor.version = version;
+    }
+    // An event from another server run leaves the cursor alone; the resync
+    // on reconnect gets `reset` back and starts over from the new run
+  }
+
+  // Fetch and apply everything after the cursor. A call while one is
+  // running schedules one more pass instead of a second request.
+  sync(): Promise<void> {
+    if (this.running) {
+      this.again = true;
+      return this.running;
+    }
+    const running = this.pass().then(
+      () => this.finish(),
+      error => {
+        this.finish();
+        throw error;
+      }
+    );
+    this.running = running;
+    return running;
+  }
+
+  private finish(): Promise<void> | void {
+    this.running = null;
+    if (this.again) {
+      this.again = false;
+      return this.sync();
+    }
+  }
+
+  private async pass(): Promise<void> {
+    for (;;) {
+      const since = this.cursor;
+      const response = await this.fetchChanges(since ? since.version : 0, since ? since.epoch : NO_EPOCH);
+      const changes = response.data;
+      if (!changes) {
+        return;
+      }
+
+      if (changes.reset) {
+        this.cursor = { epoch: changes.epoch, version: changes.version };
+        // Too far behind (or the server restarted): the feed itself is stale.
+        // Without a previous cursor this was only the baseline request.
+        // Buffered events go first, so the fresh page has the last word.
+        if (since) {
+          this.buffer.flush();
+          await this.refetch();
+        }
+        return;
+      }
+
+      this.apply(changes);
+      const cursor = this.cursor;
+      if (!cursor || cursor.epoch !== changes.epoch || changes.version > cursor.version) {
+        this.cursor = { epoch: changes.epoch, version: changes.version };
+      }
+      if (!changes.hasMore) {
+        return;
+      }
+    }
+  }
+
+  private apply(changes: PostChangeSet): void {
+    const run = `resync${++this.run}`;
+    const timestamp = Date.now();
+    let seq = 0;
+    const push = (type: WebSocketMessageType, payload: unknown) => {
+      seq++;
+      this.buffer.push({ type, payload, timestamp, messageId: `${run}-${seq}`, userId: '', seq });
+    };
+
+    changes.created.forEach((post: Post) => push('POST_CREATED', { post }));
+    changes.updated.forEach((post: Post) => push('POST_UPDATED', { post }));
+    changes.deleted.forEach(postId => push('POST_DELETED', { postId }));
+  }
+}
+
+// Stream the feed topic of `connection` into the posts store, re-syncing
+// after a RESYNC and on every (re)connect. Returns the unsubscribe
+// function; buffered events are applied before it returns.
+export function connectPostEvents(
+  connection: RealtimeConnection,
+  buffer: PostEventBuffer = new PostEventBuffer(),
+  resync: PostsResync = new PostsResync(buffer)
+): () => void {
+  const sync = () => {
+    resync.sync().catch(() => undefined);
+  };
+
+  const unsubscribe = connection.subscribe('feed', event => {
+    resync.observe(event);
+    buffer.push(event);
+  });
+  const stopResync = connection.onMessage(message => {
+    if (message.type === 'RESYNC') {
+      sync();
+    }
+  });
+  const stopStates = connection.onStateChange(state => {
+    if (state === 'connected') {
+      sync();
+    }
+  });
+  // Already connected (another subscriber opened the socket first)
+  if (connection.state === 'connected') {
+    sync();
+  }
+
+  return () => {
+    unsubscribe();
+    stopResync();
+    stopStates();
+    buffer.flush();
+  };
+}
@@ -1,88 +1,548 @@
-import { create } from 'zustand';
-import { PostsStore, Post, CreatePostData, UpdatePostData } from '@/types';
-import { mockPosts, generateId, currentUser } from '@/utils/mockData';
-
-// TODO: Complete this store implementation
-// Issues to fix:
-// 1. Add proper error handling
-// 2. Implement missing functions
-// 3. Add loading states
-// 4. Fix TypeScript errors
-
-export const usePostsStore = create<PostsStore>((set, get) => ({
-  posts: [...mockPosts],
+import { ReactNode, createContext, createElement, useContext, useMemo, useRef } from 'react';
+import { StoreApi, createStore, useStore } from 'zustand';
+import { ApiResponse, PaginatedResponse, PostsStore, PostsPatch, Post, StoredPost, SyncCursor, User, CreatePostData, UpdatePostData } from '@/types';
+import { PostDeletedPayload, PostLikedPayload, PostPayload, WebSocketMessage } from '@/types/websocket';
+import { PostsQuery, postsApi, postsListUrl, responseCache } from '@/utils/api';
+import { generateId, currentUser } from '@/utils/mockData';
+import { postsOutbox } from '@/utils/outbox';
+
+// Posts are normalized into `byId` + `orderedIds`, with each author stored
+// once in `authorsById`. Updates replace only the records they touch, so a
+// component subscribed through usePost(id) re-renders only when that post
+// (or its author) changes, not when any other post does.
+//
+// Writes are optimistic: the store changes at once and the write goes to
+// the offline outbox (utils/outbox.ts), which syncs it when it can.
+//
+// The feed starts empty and is loaded from GET /api/posts (or seeded with
+// the server-rendered page). The browser has one store for the whole page. Server rendering gets a
+// fresh store per request (see PostsStoreProvider), so requests rendered
+// concurrently never see each other's posts.
+
+type NormalizedPosts = Pick<PostsStore, 'byId' | 'orderedIds' | 'authorsById'>;
+
+// Posts per feed page, on the server-rendered page and in fetchPosts
+export const FEED_PAGE_SIZE = 20;
+const FEED_QUERY: PostsQuery = { limit: FEED_PAGE_SIZE };
+
+function byNewest(byId: Record<string, StoredPost>) {
+  return (a: string, b: string) => {
+    const first = byId[a].createdAt;
+    const second = byId[b].createdAt;
+    return first < second ? 1 : first > second ? -1 : 0;
+  };
+}
+
+function samePost(a: StoredPost, b: StoredPost): boolean {
+  return (
+    a.title === b.title &&
+    a.content === b.content &&
+    a.imageUrl === b.imageUrl &&
+    a.imagePlaceholder === b.imagePlaceholder &&
+    a.likes === b.likes &&
+    a.updatedAt === b.updatedAt &&
+    sameIds(a.likedBy, b.likedBy)
+  );
+}
+
+function sameIds(a: string[], b: string[]): boolean {
+  if (a.length !== b.length) {
+    return false;
+  }
+  for (let i = 0; i < a.length; i++) {
+    if (a[i] !== b[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+function sameUser(a: User, b: User): boolean {
+  return (
+    a.name === b.name &&
+    a.email === b.email &&
+    a.avatar === b.avatar &&
+    a.bio === b.bio &&
+    a.postsCount === b.postsCount &&
+    a.likesReceived === b.likesReceived
+  );
+}
+
+function splitPost(post: Post): StoredPost {
+  const { author, ...record } = post;
+  return record;
+}
+
+// Upsert `posts` into the normalized state. Records (and authors) that did
+// not change keep their identity, so their subscribers do not re-render.
+function mergePosts(state: NormalizedPosts, posts: Post[]): NormalizedPosts {
+  let byId = state.byId;
+  let authorsById = state.authorsById;
+  const added: string[] = [];
+
+  posts.forEach(post => {
+    const author = authorsById[post.authorId];
+    if (!author || !sameUser(author, post.author)) {
+      if (authorsById === state.authorsById) {
+        authorsById = { ...authorsById };
+      }
+      authorsById[post.authorId] = post.author;
+    }
+
+    const existing = byId[post.id];
+    if (!existing || !samePost(existing, post)) {
+      if (byId === state.byId) {
+        byId = { ...byId };
+      }
+      byId[post.id] = splitPost(post);
+      if (!existing) {
+        added.push(post.id);
+      }
+    }
+  });
+
+  const orderedIds = added.length
+    ? state.orderedIds.concat(added).sort(byNewest(byId))
+    : state.orderedIds;
+
+  return { byId, orderedIds, authorsById };
+}
+
+// The store as of a freshly loaded first page: posts that are not on it are
+// dropped. Posts with writes still queued in the outbox keep their local
+// state (or stay deleted) until those settle. Unchanged records keep their
+// identity, as in mergePosts.
+function replacePosts(state: NormalizedPosts, posts: Post[]): NormalizedPosts {
+  const byId: Record<string, StoredPost> = {};
+  const orderedIds: string[] = [];
+  const keep = (id: string) => {
+    if (state.byId[id] && !byId[id]) {
+      byId[id] = state.byId[id];
+      orderedIds.push(id);
+    }
+  };
+
+  const settled = posts.filter(post => !postsOutbox.hasPending(post.id));
+  settled.forEach(post => keep(post.id));
+  state.orderedIds.forEach(id => {
+    if (postsOutbox.hasPending(id)) {
+      keep(id);
+    }
+  });
+  orderedIds.sort(byNewest(byId));
+
+  return mergePosts({ byId, orderedIds, authorsById: state.authorsById }, settled);
+}
+
+// Realtime events in the order the gateway produced them. `seq` orders
+// events from one server run; across runs (the messageId prefix changes
+// after a restart) the timestamp decides. Duplicates are dropped.
+export function orderEvents(events: WebSocketMessage[]): WebSocketMessage[] {
+  const seen = new Set<string>();
+  const unique = events.filter(event => {
+    if (seen.has(event.messageId)) {
+      return false;
+    }
+    seen.add(event.messageId);
+    return true;
+  });
+
+  const runOf = (event: WebSocketMessage) => event.messageId.split('-')[0];
+  return unique.sort((a, b) =>
+    runOf(a) === runOf(b) ? a.seq - b.seq : a.timestamp - b.timestamp || a.seq - b.seq
+  );
+}
+
+interface LikeChange {
+  likes: number;
+  likers: Record<string, boolean>; // userId -> liked, latest wins
+}
+
+interface CollapsedEvents {
+  upserts: Record<string, Post>;
+  likes: Record<string, LikeChange>;
+  deleted: Record<string, true>;
+}
+
+// Reduce a batch to at most one change per post: the latest full post,
+// else the latest like count (plus who liked/unliked), or a delete
+function collapseEvents(events: WebSocketMessage[]): CollapsedEvents {
+  const collapsed: CollapsedEvents = { upserts: {}, likes: {}, deleted: {} };
+
+  orderEvents(events).forEach(event => {
+    switch (event.type) {
+      case 'POST_CREATED':
+      case 'POST_UPDATED': {
+        const { post } = event.payload as PostPayload;
+        collapsed.upserts[post.id] = post;
+        delete collapsed.likes[post.id];
+        delete collapsed.deleted[post.id];
+        break;
+      }
+      case 'POST_LIKED': {
+        const { postId, likes, liked } = event.payload as PostLikedPayload;
+        const upsert = collapsed.upserts[postId];
+        if (upsert) {
+          const likedBy = upsert.likedBy.filter(id => id !== event.userId);
+          collapsed.upserts[postId] = {
+            ...upsert,
+            likes,
+            likedBy: liked ? likedBy.concat(event.userId) : likedBy,
+          };
+        } else if (!collapsed.deleted[postId]) {
+          const change = collapsed.likes[postId] || (collapsed.likes[postId] = { likes, likers: {} });
+          change.likes = likes;
+          change.likers[event.userId] = liked;
+        }
+        break;
+      }
+      case 'POST_DELETED': {
+        const { postId } = event.payload as PostDeletedPayload;
+        collapsed.deleted[postId] = true;
+        delete collapsed.upserts[postId];
+        delete collapsed.likes[postId];
+        break;
+      }
+    }
+  });
+
+  return collapsed;
+}
+
+function applyLike(record: StoredPost, change: LikeChange): StoredPost {
+  let likedBy = record.likedBy;
+  Object.keys(change.likers).forEach(userId => {
+    const has = likedBy.indexOf(userId) !== -1;
+    if (change.likers[userId] && !has) {
+      likedBy = likedBy.concat(userId);
+    } else if (!change.likers[userId] && has) {
+      likedBy = likedBy.filter(id => id !== userId);
+    }
+  });
+
+  if (likedBy === record.likedBy && change.likes === record.likes) {
+    return record;
+  }
+  return { ...record, likes: change.likes, likedBy };
+}
+
+function withoutPost(state: NormalizedPosts, id: string): Pick<NormalizedPosts, 'byId' | 'orderedIds'> {
+  const { [id]: removed, ...byId } = state.byId;
+  return { byId, orderedIds: state.orderedIds.filter(postId => postId !== id) };
+}
+
+const emptyPosts: NormalizedPosts = { byId: {}, orderedIds: [], authorsById: {} };
+
+export const createPostsStore = (): StoreApi<PostsStore> => createStore<PostsStore>((set, get) => ({
+  ...emptyPosts,
   loading: false,
   error: null,
+  fetchedAt: null,
+  serverVersion: null,
 
   fetchPosts: async () => {
-    // TODO: Implement this function
-    // Should:
-    // 1. Set loading to true
-    // 2. Simulate API call (use setTimeout for 1 second)
-    // 3. Update posts with mock data
-    // 4. Handle errors properly
-    // 5. Set loading to false
-    
-    console.log('fetchPosts not implemented yet');
+    set({ loading: true, error: null });
+
+    try {
+      const response = await postsApi.getAll(FEED_QUERY);
+      const page = response.data as PaginatedResponse<Post>;
+      set({ ...replacePosts(get(), page.data), loading: false, fetchedAt: Date.now() });
+    } catch (error) {
+      set({
+        error: error instanceof Error ? error.message : 'Failed to fetch posts',
+        loading: false,
+      });
+    }
+  },
+
+  hydrate: (posts: Post[], version?: SyncCursor) => {
+    set({
+      ...mergePosts(emptyPosts, posts),
+      loading: false,
+      error: null,
+      fetchedAt: Date.now(),
+      serverVersion: version || null,
+    });
+  },
+
+  receivePosts: (posts: Post[]) => {
+    const state = get();
+    const next = mergePosts(state, posts);
+    if (
+      next.byId !== state.byId ||
+      next.orderedIds !== state.orderedIds ||
+      next.authorsById !== state.authorsById
+    ) {
+      set(next);
+    }
+  },
+
+  applyEvents: (events: WebSocketMessage[]) => {
+    const state = get();
+    const { upserts, likes, deleted } = collapseEvents(events);
+    const merged = mergePosts(state, Object.keys(upserts).map(id => upserts[id]));
+    let byId = merged.byId;
+    let orderedIds = merged.orderedIds;
+
+    Object.keys(likes).forEach(id => {
+      const record = byId[id];
+      // Likes for a post this client has not loaded are not worth a fetch
+      const next = record && applyLike(record, likes[id]);
+      if (next && next !== record) {
+        if (byId === state.byId) {
+          byId = { ...byId };
+        }
+        byId[id] = next;
+      }
+    });
+
+    const removed = Object.keys(deleted).filter(id => byId[id]);
+    if (removed.length) {
+      byId = { ...byId };
+      removed.forEach(id => {
+        delete byId[id];
+      });
+      orderedIds = orderedIds.filter(id => !deleted[id]);
+    }
+
+    if (
+      byId !== state.byId ||
+      orderedIds !== state.orderedIds ||
+      merged.authorsById !== state.authorsById
+    ) {
+      set({ byId, orderedIds, authorsById: merged.authorsById });
+    }
+  },
+
+  applyPatch: ({ posts, deleted }: PostsPatch) => {
+    const state = get();
+    let next = mergePosts(state, posts);
+    deleted.forEach(id => {
+      if (next.byId[id]) {
+        next = { ...next, ...withoutPost(next, id) };
+      }
+    });
+    if (
+      next.byId !== state.byId ||
+      next.orderedIds !== state.orderedIds ||
+      next.authorsById !== state.authorsById
+    ) {
+      set(next);
+    }
   },
 
   createPost: async (data: CreatePostData) => {
-    // TODO: Implement this function
-    // Should:
-    // 1. Validate the data
-    // 2. Create a new post with generated ID
-    // 3. Add current user as author
-    // 4. Add to the beginning of posts array
-    // 5. Handle errors
-    
-    console.log('createPost not implemented yet', data);
+    if (!data.title || !data.content) {
+      set({ error: 'Title and content are required' });
+      return;
+    }
+
+    const now = new Date().toISOString();
+    const post: Post = {
+      id: generateId(),
+      title: data.title,
+      content: data.content,
+      imageUrl: data.imageUrl,
+      authorId: currentUser.id,
+      author: currentUser,
+      likes: 0,
+      likedBy: [],
+      createdAt: now,
+      updatedAt: now,
+    };
+
+    get().receivePosts([post]);
+    postsOutbox.enqueue({ type: 'create', postId: post.id, data });
   },
 
   updatePost: async (id: string, data: UpdatePostData) => {
-    // TODO: Implement this function
-    // Should:
-    // 1. Find the post by ID
-    // 2. Update only the provided fields
-    // 3. Update the updatedAt timestamp
-    // 4. Handle case where post doesn't exist
-    
-    console.log('updatePost not implemented yet', id, data);
+    const { byId } = get();
+    const existing = byId[id];
+    if (!existing) {
+      set({ error: 'Post not found' });
+      return;
+    }
+
+    set({
+      byId: {
+        ...byId,
+        [id]: { ...existing, ...data, updatedAt: new Date().toISOString() },
+      },
+    });
+    postsOutbox.enqueue({ type: 'update', postId: id, data });
   },
 
   deletePost: async (id: string) => {
-    // TODO: Implement this function
-    // Should:
-    // 1. Remove post from array
-    // 2. Handle case where post doesn't exist
-    // 3. Show success message
-    
-    console.log('deletePost not implemented yet', id);
+    const state = get();
+    if (!state.byId[id]) {
+      set({ error: 'Post not found' });
+      return;
+    }
+
+    set(withoutPost(state, id));
+    postsOutbox.enqueue({ type: 'delete', postId: id });
   },
 
   likePost: async (id: string, userId: string) => {
-    // This function has bugs - fix them!
-    const posts = get().posts;
-    const postIndex = posts.findIndex(p => p.id === id);
-    
-    if (postIndex === -1) return;
-    
-    const post = posts[postIndex];
+    const { byId } = get();
+    const post = byId[id];
+    if (!post) return;
+
     const isLiked = post.likedBy.includes(userId);
-    
-    // BUG: This doesn't properly update the state
-    if (isLiked) {
-      post.likedBy.filter(id => id !== userId);
-      post.likes--;
-    } else {
-      post.likedBy.push(userId);
-      post.likes++;
-    }
-    
-    // BUG: This doesn't trigger a re-render
-    posts[postIndex] = post;
+
+    // Replace just this record; every other post keeps its identity
+    set({
+      byId: {
+        ...byId,
+        [id]: {
+          ...post,
+          likes: post.likes + (isLiked ? -1 : 1),
+          likedBy: isLiked
+            ? post.likedBy.filter(likerId => likerId !== userId)
+            : post.likedBy.concat(userId),
+        },
+      },
+    });
+    postsOutbox.enqueue({ type: 'like', postId: id, userId, liked: !isLiked });
   },
 
   clearError: () => {
     set({ error: null });
   },
 }));
+
+const browserStore = createPostsStore();
+const PostsStoreContext = createContext<StoreApi<PostsStore>>(browserStore);
+
+function usePostsSelector<T>(selector: (state: PostsStore) => T): T {
+  return useStore(useContext(PostsStoreContext), selector);
+}
+
+// Hook over the store in context; getState/setState/subscribe reach the
+// browser store directly, for code outside React
+export const usePostsStore = Object.assign(usePostsSelector, browserStore);
+
+// Reconcile with the server as the outbox settles writes. A post with more
+// writes still queued keeps its optimistic state until those settle too.
+postsOutbox.onResult((result, mutation) => {
+  const store = usePostsStore.getState();
+  if (result.status < 300) {
+    if (result.post && !postsOutbox.hasPending(mutation.postId)) {
+      store.receivePosts([result.post]);
+    }
+    return;
+  }
+
+  // Gone on the server (or never accepted there): drop the local copy
+  const missing = result.status === 404 || (mutation.type === 'create' && result.status !== 409);
+  usePostsStore.setState({
+    ...(missing && store.byId[mutation.postId] ? withoutPost(store, mutation.postId) : {}),
+    error: `Could not save your change: ${result.error || `error ${result.status}`}`,
+  });
+});
+
+// fetchPosts may be answered from a stale cached page while it is refreshed
+// in the background; the fresh page replaces it when it lands
+responseCache.subscribe((key, value) => {
+  const page = key === postsListUrl(FEED_QUERY) && (value as ApiResponse<PaginatedResponse<Post>>).data;
+  if (page) {
+    usePostsStore.setState(state => ({ ...replacePosts(state, page.data), fetchedAt: Date.now() }));
+  }
+});
+
+// Joined Post objects are cached per record, so a post keeps the same object
+// identity until its record or its author changes
+const joined = new WeakMap<StoredPost, Post>();
+
+export function denormalizePost(record: StoredPost, author: User): Post {
+  const cached = joined.get(record);
+  if (cached && cached.author === author) {
+    return cached;
+  }
+  const post: Post = { ...record, author };
+  joined.set(record, post);
+  return post;
+}
+
+let lastSelection: { source: NormalizedPosts; posts: Post[] } | null = null;
+
+// All posts, newest first. Recomputed only when the normalized state
+// changes; unchanged posts come back as the same objects.
+export function selectPosts(state: PostsStore): Post[] {
+  if (
+    lastSelection &&
+    lastSelection.source.byId === state.byId &&
+    lastSelection.source.orderedIds === state.orderedIds &&
+    lastSelection.source.authorsById === state.authorsById
+  ) {
+    return lastSelection.posts;
+  }
+
+  const posts = state.orderedIds.map(id => {
+    const record = state.byId[id];
+    return denormalizePost(record, state.authorsById[record.authorId]);
+  });
+  lastSelection = {
+    source: { byId: state.byId, orderedIds: state.orderedIds, authorsById: state.authorsById },
+    posts,
+  };
+  return posts;
+}
+
+interface PostsStoreProviderProps {
+  initialPosts?: Post[];
+  initialVersion?: SyncCursor; // Store version the posts were read at
+  children?: ReactNode;
+}
+
+// Seeds the store with server-rendered posts before the first render, so
+// the server and the hydrating client render the same markup and the client
+// does not fetch them again.
+//
+// On the server each request gets its own store. In the browser the shared
+// store is seeded once: on the first page load it takes exactly the server's
+// posts (to match the HTML); after that, e.g. on client-side navigation
+// back to the feed, the posts are merged in and optimistic or realtime
+// changes are kept. The version is where the realtime resync picks up, so
+// writes made before the socket connects are not missed.
+export function PostsStoreProvider({ initialPosts, initialVersion, children }: PostsStoreProviderProps) {
+  const store = useRef<StoreApi<PostsStore> | null>(null);
+  if (!store.current) {
+    if (typeof window === 'undefined') {
+      store.current = createPostsStore();
+      if (initialPosts) {
+        store.current.getState().hydrate(initialPosts, initialVersion);
+      }
+    } else {
+      store.current = browserStore;
+      if (initialPosts) {
+        const state = browserStore.getState();
+        if (state.fetchedAt) {
+          state.receivePosts(initialPosts);
+          if (initialVersion) {
+            browserStore.setState({ serverVersion: initialVersion });
+          }
+        } else {
+          state.hydrate(initialPosts, initialVersion);
+        }
+      }
+    }
+  }
+  return createElement(PostsStoreContext.Provider, { value: store.current }, children);
+}
+
+export function usePosts(): Post[] {
+  return usePostsStore(selectPosts);
+}
+
+// Subscribes to a single post: re-renders only when that post or its author
+// is replaced
+export function usePost(id: string): Post | undefined {
+  const record = usePostsStore(state => state.byId[id]);
+  const author = usePostsStore(state => (record ? state.authorsById[record.authorId] : undefined));
+
+  return useMemo(
+    () => (record && author ? denormalizePost(record, author) : undefined),
+    [record, author]
+  );
+}
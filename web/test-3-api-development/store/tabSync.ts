@@ -0,0 +1,173 @@
+import { Post, PostsPatch, PostsStore } from '@/types';
+import { QueuedMutation, postsOutbox } from '@/utils/outbox';
+import { TabLeader } from '@/utils/tabLeader';
+import { getRealtimeConnection } from '@/utils/websocket';
+import { PostEventBuffer, PostsResync, connectPostEvents } from './postEvents';
+import { denormalizePost, selectPosts, usePostsStore } from './posts';
+
+// One network presence per browser, however many tabs are open.
+//
+// The leader tab (utils/tabLeader.ts) is the only one that fetches posts,
+// holds the realtime connection and drains the outbox. It broadcasts every
+// change to its store as a patch of the posts that changed. Follower tabs
+// apply those patches, and send their own writes to the leader, which
+// applies and queues them as if they were its own. Those writes are in the
+// shared IndexedDB outbox before they are sent, so when the leader closes
+// the next tab takes over and picks them up with the rest of the outbox.
+
+export type TabMessage =
+  | { type: 'hello' } // A follower wants the leader's state
+  | { type: 'snapshot'; posts: Post[] }
+  | { type: 'patch'; patch: PostsPatch }
+  | { type: 'mutation'; mutation: QueuedMutation; posts: Post[] }; // A follower's write and its optimistic result
+
+type PostsState = Pick<PostsStore, 'byId' | 'authorsById'>;
+
+// Posts replaced or removed between two states (null when none). Cheap
+// because unchanged records and authors keep their identity.
+export function diffPosts(previous: PostsState, next: PostsState): PostsPatch | null {
+  if (previous.byId === next.byId && previous.authorsById === next.authorsById) {
+    return null;
+  }
+
+  const posts: Post[] = [];
+  const deleted: string[] = [];
+  Object.keys(next.byId).forEach(id => {
+    const record = next.byId[id];
+    const author = next.authorsById[record.authorId];
+    if (record !== previous.byId[id] || author !== previous.authorsById[record.authorId]) {
+      posts.push(denormalizePost(record, author));
+    }
+  });
+  Object.keys(previous.byId).forEach(id => {
+    if (!next.byId[id]) {
+      deleted.push(id);
+    }
+  });
+
+  return posts.length || deleted.length ? { posts, deleted } : null;
+}
+
+function currentPost(id: string): Post[] {
+  const state = usePostsStore.getState();
+  const record = state.byId[id];
+  return record ? [denormalizePost(record, state.authorsById[record.authorId])] : [];
+}
+
+// Join the tab election for `userId`. Returns the function that leaves it.
+export function startTabSync(userId: string, tabs = new TabLeader<TabMessage>('posts-sync')): () => void {
+  let stopLeading: (() => void) | null = null;
+
+  const lead = () => {
+    postsOutbox.forwardTo(null);
+    const stopOutbox = postsOutbox.start();
+    // Pick up writes queued by the previous leader
+    postsOutbox.reload().then(() => postsOutbox.drain());
+
+    const connection = getRealtimeConnection(userId);
+    const buffer = new PostEventBuffer();
+    const resync = new PostsResync(buffer);
+    const { serverVersion } = usePostsStore.getState();
+    if (serverVersion) {
+      resync.seed(serverVersion);
+    }
+    const stopEvents = connectPostEvents(connection, buffer, resync);
+    const stopReconnects = connection.onStateChange(state => {
+      if (state === 'connected') {
+        postsOutbox.drain();
+      }
+    });
+    const stopPatches = usePostsStore.subscribe((state, previous) => {
+      const patch = diffPosts(previous, state);
+      if (patch) {
+        tabs.post({ type: 'patch', patch });
+      }
+    });
+
+    // Server-rendered pages arrive with their posts already in the store.
+    // Followers get a snapshot once the leader holds the server's posts.
+    let leading = true;
+    const store = usePostsStore.getState();
+    const loaded = store.fetchedAt ? Promise.resolve() : store.fetchPosts();
+    loaded.then(() => {
+      if (leading) {
+        postSnapshot();
+      }
+    });
+
+    stopLeading = () => {
+      leading = false;
+      stopPatches();
+      stopReconnects();
+      stopEvents();
+      stopOutbox();
+      // The next leader opens its own
+      connection.close();
+    };
+  };
+
+  const stopMessages = tabs.onMessage(message => {
+    const store = usePostsStore.getState();
+    if (tabs.isLeader) {
+      if (message.type === 'hello') {
+        postSnapshot();
+      } else if (message.type === 'mutation') {
+        const { mutation, posts } = message;
+        store.applyPatch({ posts, deleted: mutation.type === 'delete' ? [mutation.postId] : [] });
+        postsOutbox.adopt(mutation);
+      }
+      return;
+    }
+
+    if (message.type === 'patch') {
+      store.applyPatch(message.patch);
+    } else if (message.type === 'snapshot') {
+      const known = new Set(message.posts.map(post => post.id));
+      store.applyPatch({
+        posts: message.posts,
+        deleted: store.orderedIds.filter(id => !known.has(id)),
+      });
+    }
+  });
+
+  // A snapshot replaces the followers' posts, so an unloaded (or failed)
+  // store is never sent as one
+  const postSnapshot = () => {
+    const state = usePostsStore.getState();
+    if (state.fetchedAt) {
+      tabs.post({ type: 'snapshot', posts: selectPosts(state) });
+    }
+  };
+
+  const follow = () => {
+    postsOutbox.forwardTo(mutation => tabs.post({ type: 'mutation', mutation, posts: currentPost(mutation.postId) }));
+  };
+
+  const stopLeadership = tabs.onLeadershipChange(leader => {
+    if (leader) {
+      lead();
+    } else if (stopLeading) {
+      stopLeading();
+      stopLeading = null;
+      follow();
+    }
+  });
+
+  // Every tab starts as a follower until the election says otherwise
+  follow();
+  tabs.start();
+  if (!tabs.isLeader) {
+    tabs.post({ type: 'hello' });
+  }
+
+  return () => {
+    stopMessages();
+    stopLeadership();
+    if (stopLeading) {
+      stopLeading();
+      stopLeading = null;
+    }
+    postsOutbox.forwardTo(null);
+    tabs.close();
+  };
+}
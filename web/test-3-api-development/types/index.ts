@@ -1,3 +1,5 @@
+import type { WebSocketMessage } from './websocket';
+
 // User types
 export interface User {
   id: string;
@@ -18,6 +20,7 @@ export interface Post {
   authorId: string;
   author: User;
   imageUrl?: string;
+  imagePlaceholder?: string; // Tiny blurred data: URI shown while the image loads
   likes: number;
   likedBy: string[]; // Array of user IDs who liked this post
   createdAt: string;
@@ -47,19 +50,91 @@ export interface ApiResponse<T> {
 export interface PaginatedResponse<T> {
   data: T[];
   total: number;
-  page: number;
   limit: number;
   hasMore: boolean;
+  nextCursor: string | null; // Opaque token for the next page, null on the last page
+}
+
+// POST /api/posts/batch: posts found, plus the requested ids that were not
+export interface PostBatch {
+  posts: Post[];
+  missing: string[];
+}
+
+// POST /api/posts/[id]/like: the like state after the write. `version` is
+// the post's version, as in its ETag.
+export interface LikeState {
+  likes: number;
+  liked: boolean;
+  version: number;
+}
+
+// Delta sync: everything that changed after a store version
+export interface PostChangeSet {
+  epoch: string; // Server run the versions belong to
+  version: number; // Pass back as `since` on the next poll
+  created: Post[];
+  updated: Post[];
+  deleted: string[];
+  hasMore: boolean;
+  reset: boolean; // `since` is too old (or from another server run); refetch the feed
+}
+
+// A point in the server's change history: a store version within one server
+// run. Delta sync fetches the changes after it.
+export interface SyncCursor {
+  epoch: string;
+  version: number;
+}
+
+// Offline outbox: queued writes replayed through POST /api/posts/mutations.
+// `key` is the idempotency key; a replayed key returns the stored result.
+// Creates carry the client-generated post id so later ops can refer to it.
+export type PostMutation =
+  | { key: string; type: 'create'; postId: string; data: CreatePostData }
+  | { key: string; type: 'update'; postId: string; data: UpdatePostData }
+  | { key: string; type: 'delete'; postId: string }
+  | { key: string; type: 'like'; postId: string; userId: string; liked: boolean };
+
+export interface MutationResult {
+  key: string;
+  status: number; // What the single-post endpoint would have answered
+  post?: Post;
+  error?: string;
+  replayed?: boolean; // Answered from the idempotency store
+}
+
+export interface MutationBatch {
+  results: MutationResult[];
 }
 
 // Store types
-export interface PostsStore {
+
+// Posts are stored normalized: the author lives once in `authorsById` and
+// posts reference it through `authorId`
+export type StoredPost = Omit<Post, 'author'>;
+
+// Changed and removed posts, as sent from the leader tab to the others
+export interface PostsPatch {
   posts: Post[];
+  deleted: string[];
+}
+
+export interface PostsStore {
+  byId: Record<string, StoredPost>;
+  orderedIds: string[]; // Newest first
+  authorsById: Record<string, User>;
   loading: boolean;
   error: string | null;
+  fetchedAt: number | null; // When posts were last loaded from the server
+  serverVersion: SyncCursor | null; // Version the server-rendered posts were read at
   
   // Actions
-  fetchPosts: () => Promise<void>;
+  fetchPosts: () => Promise<void>; // Load the first feed page, replacing the posts held
+  hydrate: (posts: Post[], version?: SyncCursor) => void; // Replace everything with server-rendered posts (first load only)
+  receivePosts: (posts: Post[]) => void;
+  applyEvents: (events: WebSocketMessage[]) => void; // One update for a whole batch
+  applyPatch: (patch: PostsPatch) => void;
   createPost: (data: CreatePostData) => Promise<void>;
   updatePost: (id: string, data: UpdatePostData) => Promise<void>;
   deletePost: (id: string) => Promise<void>;
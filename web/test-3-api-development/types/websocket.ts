@@ -0,0 +1,68 @@
+import { Post } from './index';
+
+// Realtime protocol spoken over /api/realtime (see server/realtime.ts)
+//
+// Topics: 'feed' carries every post event; 'post:<id>' carries the events
+// of one post plus typing/comment activity on it; 'presence' carries
+// USER_PRESENCE. A connection subscribed to several matching topics still
+// receives each message once.
+
+export type WebSocketMessageType =
+  | 'POST_CREATED'
+  | 'POST_LIKED'
+  | 'POST_UPDATED'
+  | 'POST_DELETED'
+  | 'COMMENT_ADDED'
+  | 'USER_TYPING'
+  | 'USER_PRESENCE'
+  | 'RESYNC' // Messages were dropped for this connection: re-sync via /api/posts/changes
+  | 'PONG';
+
+export interface WebSocketMessage<P = any> {
+  type: WebSocketMessageType;
+  payload: P;
+  timestamp: number;
+  messageId: string;
+  userId: string;
+  seq: number; // Gateway-wide, increasing; orders messages from one server run
+}
+
+// Store version after a post event, for delta sync (PostChangeSet)
+export interface PostEventVersion {
+  epoch?: string;
+  version?: number;
+}
+
+export interface PostLikedPayload extends PostEventVersion {
+  postId: string;
+  likes: number;
+  liked: boolean; // Whether `userId` now likes the post
+}
+
+export interface PostPayload extends PostEventVersion {
+  post: Post;
+}
+
+export interface PostDeletedPayload extends PostEventVersion {
+  postId: string;
+}
+
+// Relayed from one client to the other subscribers of the post; the gateway
+// forwards only these fields
+export interface TypingPayload {
+  postId: string;
+  typing: boolean;
+}
+
+export interface CommentAddedPayload {
+  postId: string;
+  commentId: string;
+  content: string;
+}
+
+export type ClientMessage =
+  | { type: 'SUBSCRIBE'; topics: string[] }
+  | { type: 'UNSUBSCRIBE'; topics: string[] }
+  | { type: 'PING'; id?: string }
+  | { type: 'USER_TYPING'; payload: TypingPayload }
+  | { type: 'COMMENT_ADDED'; payload: CommentAddedPayload };
@@ -1,4 +1,7 @@
 // API utility functions for making HTTP requests
+import { ApiResponse, MutationBatch, PaginatedResponse, Post, PostFilters, PostMutation } from '@/types';
+import { ResponseCache, createIndexedDbPersistence } from './responseCache';
+import { CircuitBreaker, backoffDelay, deadline, sleep } from './resilience';
 
 export class ApiError extends Error {
   constructor(public status: number, message: string) {
@@ -7,42 +10,241 @@ export class ApiError extends Error {
   }
 }
 
+export interface RequestOptions extends RequestInit {
+  timeout?: number; // Deadline in ms for the whole call, retries included
+  retries?: number;
+  idempotent?: boolean; // Allow retrying a POST that is safe to repeat
+}
+
+// Transient failures (network errors, timeouts, 408/429/5xx) are retried
+// for idempotent requests with full-jitter exponential backoff, within the
+// request's deadline. Each endpoint has a circuit breaker: after repeated
+// failures it fails fast for a cooldown instead of adding load to an API
+// that is already struggling.
+export const retryPolicy = {
+  retries: 3,
+  baseDelay: 200,
+  maxDelay: 5000,
+  timeout: 15000,
+};
+
+const IDEMPOTENT_METHODS = ['GET', 'HEAD', 'OPTIONS', 'PUT', 'DELETE'];
+// Path segments under /api/posts that are routes rather than post ids
+const POST_ROUTES = ['batch', 'changes', 'mutations'];
+
+const breakers = new Map<string, CircuitBreaker>();
+
+// "GET /api/posts/:id", so every post shares its route's breaker
+function endpointOf(method: string, url: string): string {
+  const path = url.split('?')[0].replace(/^(\/api\/posts)\/([^/]+)/, (match, base, segment) =>
+    POST_ROUTES.indexOf(segment) === -1 ? `${base}/:id` : match
+  );
+  return `${method} ${path}`;
+}
+
+function breakerFor(endpoint: string): CircuitBreaker {
+  let breaker = breakers.get(endpoint);
+  if (!breaker) {
+    breaker = new CircuitBreaker({ failureThreshold: 5, cooldown: 10000 });
+    breakers.set(endpoint, breaker);
+  }
+  return breaker;
+}
+
+function isRetryableStatus(status: number): boolean {
+  return status === 408 || status === 429 || (status >= 500 && status !== 501);
+}
+
+// Retry-After in seconds (HTTP dates are not worth the parsing here)
+function retryAfterMs(response: Response): number {
+  const value = Number(response.headers.get('Retry-After'));
+  return Number.isFinite(value) && value > 0 ? value * 1000 : 0;
+}
+
+// GETs currently on the wire, by URL. An identical GET made while one is
+// pending shares its promise (and its parsed body) instead of refetching.
+// GETs with their own abort signal are not shared: one caller giving up
+// must not reject the others.
+const inflightGets = new Map<string, Promise<unknown>>();
+
 export async function apiRequest<T>(
   url: string,
-  options: RequestInit = {}
+  options: RequestOptions = {}
 ): Promise<T> {
-  const response = await fetch(url, {
-    headers: {
-      'Content-Type': 'application/json',
-      ...options.headers,
+  const method = (options.method || 'GET').toUpperCase();
+  if (method !== 'GET' || options.signal) {
+    return send<T>(url, options);
+  }
+
+  const pending = inflightGets.get(url);
+  if (pending) {
+    return pending as Promise<T>;
+  }
+
+  const request = send<T>(url, options).then(
+    result => {
+      inflightGets.delete(url);
+      return result;
     },
-    ...options,
-  });
+    error => {
+      inflightGets.delete(url);
+      throw error;
+    }
+  );
+  inflightGets.set(url, request);
+  return request;
+}
+
+async function send<T>(url: string, options: RequestOptions): Promise<T> {
+  const {
+    timeout = retryPolicy.timeout,
+    retries = retryPolicy.retries,
+    idempotent,
+    ...init
+  } = options;
+  const method = (init.method || 'GET').toUpperCase();
+  const attempts = idempotent || IDEMPOTENT_METHODS.indexOf(method) !== -1 ? retries + 1 : 1;
+  const endpoint = endpointOf(method, url);
+  const breaker = breakerFor(endpoint);
+  const limit = deadline(timeout, init.signal);
+
+  try {
+    for (let attempt = 1; ; attempt++) {
+      if (!breaker.allow()) {
+        throw new ApiError(503, `Circuit open for ${endpoint}`);
+      }
 
-  if (!response.ok) {
-    throw new ApiError(response.status, `HTTP error! status: ${response.status}`);
+      let response: Response | null = null;
+      let networkError: unknown = null;
+      try {
+        response = await fetch(url, {
+          headers: {
+            'Content-Type': 'application/json',
+            ...init.headers,
+          },
+          ...init,
+          signal: limit.signal,
+        });
+      } catch (error) {
+        // The caller gave up: not the endpoint's fault, and not ours to retry
+        if (init.signal && init.signal.aborted) {
+          breaker.cancel();
+          throw error;
+        }
+        if (limit.signal.aborted) {
+          breaker.failure();
+          throw new ApiError(0, `Request timed out after ${timeout}ms`);
+        }
+        networkError = error;
+      }
+
+      let wait = 0;
+      let failure: ApiError;
+      if (response) {
+        if (response.ok) {
+          breaker.success();
+          return await response.json();
+        }
+        failure = new ApiError(response.status, `HTTP error! status: ${response.status}`);
+        if (!isRetryableStatus(response.status)) {
+          // The server is up and answered; retrying will not change that
+          breaker.success();
+          throw failure;
+        }
+        wait = retryAfterMs(response);
+      } else {
+        failure = new ApiError(0, networkError instanceof Error ? networkError.message : 'Network error');
+      }
+
+      breaker.failure();
+      if (attempt >= attempts) {
+        throw failure;
+      }
+
+      const delay = Math.max(wait, backoffDelay(attempt - 1, retryPolicy.baseDelay, retryPolicy.maxDelay));
+      if (Date.now() + delay >= limit.expiresAt) {
+        throw failure;
+      }
+      try {
+        await sleep(delay, limit.signal);
+      } catch (error) {
+        throw init.signal && init.signal.aborted ? error : failure;
+      }
+    }
+  } finally {
+    limit.clear();
   }
+}
+
+// Stale-while-revalidate cache for post reads, mirrored to IndexedDB in the
+// browser so a repeat visit renders the feed before the network answers.
+// Inspect `responseCache.stats` for hit/miss counts.
+export const responseCache = new ResponseCache({
+  ttl: 30 * 1000,
+  maxEntries: 200,
+  maxBytes: 4 * 1024 * 1024,
+  persistence: typeof indexedDB === 'undefined' ? undefined : createIndexedDbPersistence('posts-api-cache'),
+});
 
-  return response.json();
+const cachedGet = <T>(url: string, fetcher: () => Promise<T> = () => apiRequest<T>(url)) =>
+  responseCache.get(url, fetcher);
+
+// GET /api/posts parameters: filters plus the keyset page to read
+export interface PostsQuery extends PostFilters {
+  limit?: number;
+  cursor?: string; // `nextCursor` of the previous page
+}
+
+// URL of one listing page, which is also its responseCache key
+export function postsListUrl(query: PostsQuery = {}): string {
+  const params: string[] = [];
+  (Object.keys(query) as (keyof PostsQuery)[]).forEach(name => {
+    const value = query[name];
+    if (value !== undefined && value !== '') {
+      params.push(`${name}=${encodeURIComponent(String(value))}`);
+    }
+  });
+  return params.length ? `/api/posts?${params.join('&')}` : '/api/posts';
+}
+
+// Any write can change any listing, so it drops every cached post read
+function invalidatePosts<T>(request: Promise<T>): Promise<T> {
+  return request.then(result => {
+    responseCache.invalidate('/api/posts');
+    return result;
+  });
 }
 
 // Posts API functions
 export const postsApi = {
-  getAll: () => apiRequest<any>('/api/posts'),
-  getById: (id: string) => apiRequest<any>(`/api/posts/${id}`),
-  create: (data: any) => apiRequest<any>('/api/posts', {
+  getAll: (query?: PostsQuery) => cachedGet<ApiResponse<PaginatedResponse<Post>>>(postsListUrl(query)),
+  getById: (id: string) => cachedGet<ApiResponse<Post>>(`/api/posts/${id}`),
+  getChanges: (since: number, epoch?: string) =>
+    apiRequest<any>(`/api/posts/changes?since=${since}${epoch ? `&epoch=${epoch}` : ''}`),
+  create: (data: any) => invalidatePosts(apiRequest<any>('/api/posts', {
     method: 'POST',
     body: JSON.stringify(data),
-  }),
-  update: (id: string, data: any) => apiRequest<any>(`/api/posts/${id}`, {
+  })),
+  update: (id: string, data: any) => invalidatePosts(apiRequest<any>(`/api/posts/${id}`, {
     method: 'PUT',
     body: JSON.stringify(data),
-  }),
-  delete: (id: string) => apiRequest<any>(`/api/posts/${id}`, {
+  })),
+  delete: (id: string) => invalidatePosts(apiRequest<any>(`/api/posts/${id}`, {
     method: 'DELETE',
-  }),
+  })),
+  // An explicit like/unlike can be repeated safely; a toggle cannot
+  like: (id: string, liked?: boolean) => invalidatePosts(apiRequest<any>(`/api/posts/${id}/like`, {
+    method: 'POST',
+    body: JSON.stringify({ liked }),
+    idempotent: liked !== undefined,
+  })),
+  // Replays outbox writes; every mutation has an idempotency key
+  mutate: (mutations: PostMutation[]) => invalidatePosts(apiRequest<ApiResponse<MutationBatch>>('/api/posts/mutations', {
+    method: 'POST',
+    body: JSON.stringify({ mutations }),
+    idempotent: true,
+  })),
 };
 
-// TODO: Add proper error handling and retry logic
 // TODO: Add request/response interceptors
 // TODO: Add loading states management
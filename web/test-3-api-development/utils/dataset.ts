@@ -0,0 +1,354 @@
+import { Post, User } from '@/types';
+import { MAX_CONTENT_LENGTH } from './validation';
+
+// Deterministic synthetic dataset for scale tests and benchmarks.
+//
+// The same options and seed always produce the same users, posts, likes and
+// comments. Every entity draws from its own random stream, seeded from
+// (seed, index), so any record can be rebuilt on its own without
+// generating the ones before it, and nothing is held in memory except two
+// counters per user.
+//
+// Distributions:
+//   - authorship is Zipfian over users (a few prolific authors, a long tail
+//     of occasional ones), and so is who likes and comments
+//   - likes per post follow a power law: most posts get a handful, a few
+//     get thousands
+//   - words are Zipfian over a fixed vocabulary, so search terms range from
+//     very common to rare
+//   - `imageRatio` of posts have an image, mostly from the resizing CDN
+//
+// Records are emitted users first, then each post followed by its comments.
+
+export interface DatasetOptions {
+  seed?: number;
+  users?: number;
+  posts?: number;
+  imageRatio?: number; // Share of posts with an image
+  maxLikes?: number; // Per post, at most `users`
+  comments?: boolean; // Generate comments (default true)
+  start?: string; // ISO time of the first post
+  days?: number; // Posts are spread evenly over this many days
+}
+
+export interface GeneratedComment {
+  id: string;
+  postId: string;
+  authorId: string;
+  content: string;
+  createdAt: string;
+}
+
+export type DatasetRecord =
+  | { type: 'user'; user: User }
+  | { type: 'post'; post: Post }
+  | { type: 'comment'; comment: GeneratedComment };
+
+export interface DatasetStats {
+  users: number;
+  posts: number;
+  likes: number;
+  comments: number;
+}
+
+// Seedable pseudo-random numbers in [0, 1) (mulberry32), so runs are repeatable
+export function createRandom(seed: number): () => number {
+  let state = seed >>> 0;
+  return () => {
+    state = (state + 0x6d2b79f5) >>> 0;
+    let t = state;
+    t = Math.imul(t ^ (t >>> 15), t | 1);
+    t ^= t + Math.imul(t ^ (t >>> 7), t | 61);
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+  };
+}
+
+// Seed of the random stream for one entity
+function entitySeed(seed: number, index: number, stream: number): number {
+  let h = Math.imul(seed ^ 0x9e3779b9, 0x85ebca6b) ^ index;
+  h = Math.imul(h ^ (h >>> 16), 0x7feb352d);
+  h ^= Math.imul(stream + 1, 0xc2b2ae35);
+  h = Math.imul(h ^ (h >>> 15), 0x846ca68b);
+  return (h ^ (h >>> 16)) >>> 0;
+}
+
+// Zipf-distributed index in [0, n): index k is drawn with probability
+// roughly proportional to 1 / (k + 1)^exponent (continuous inversion, O(1))
+export function createZipf(n: number, exponent: number): (random: () => number) => number {
+  const power = 1 - exponent;
+  if (power === 0) {
+    const logSpan = Math.log(n + 1);
+    return random => Math.min(n, Math.floor(Math.exp(logSpan * random()))) - 1;
+  }
+  const span = Math.pow(n + 1, power) - 1;
+  return random => {
+    const x = Math.pow(span * random() + 1, 1 / power);
+    return Math.min(n, Math.floor(x)) - 1;
+  };
+}
+
+// Power-law sample >= 0: P(X > x) falls off as x^-alpha
+function pareto(random: () => number, scale: number, alpha: number): number {
+  return scale * (Math.pow(1 - random(), -1 / alpha) - 1);
+}
+
+const FIRST_NAMES = [
+  'Alice', 'Bob', 'Carol', 'David', 'Erin', 'Frank', 'Grace', 'Hassan', 'Ines', 'Jun',
+  'Kofi', 'Lena', 'Mateo', 'Nadia', 'Omar', 'Priya', 'Quinn', 'Rosa', 'Sven', 'Tara',
+  'Uma', 'Victor', 'Wen', 'Ximena', 'Yusuf', 'Zoe',
+];
+const LAST_NAMES = [
+  'Johnson', 'Smith', 'Davis', 'Wilson', 'Garcia', 'Nguyen', 'Okafor', 'Kowalski', 'Tanaka',
+  'Haddad', 'Silva', 'Novak', 'Larsen', 'Moreau', 'Rossi', 'Singh', 'Kim', 'Ali',
+];
+// Roughly in order of how often they should appear
+const VOCABULARY = [
+  'the', 'react', 'performance', 'api', 'state', 'typescript', 'next', 'server', 'design',
+  'component', 'hooks', 'cache', 'testing', 'render', 'data', 'query', 'mobile', 'browser',
+  'layout', 'network', 'database', 'index', 'stream', 'deploy', 'cloud', 'security', 'store',
+  'memory', 'async', 'router', 'animation', 'accessibility', 'latency', 'throughput', 'css',
+  'grid', 'flexbox', 'bundle', 'webpack', 'compiler', 'types', 'generics', 'promise', 'worker',
+  'offline', 'sync', 'realtime', 'socket', 'queue', 'retry', 'backoff', 'metrics', 'tracing',
+  'logging', 'profiling', 'benchmark', 'refactor', 'migration', 'schema', 'validation',
+  'pagination', 'cursor', 'search', 'ranking', 'feed', 'image', 'video', 'upload', 'auth',
+  'session', 'token', 'edge', 'region', 'replica', 'shard', 'consensus', 'snapshot', 'journal',
+  'garbage', 'allocation', 'hydration', 'suspense', 'streaming', 'prefetch', 'lazy', 'virtual',
+  'windowing', 'debounce', 'throttle', 'idempotent', 'monotonic', 'vector', 'embedding',
+  'kubernetes', 'container', 'serverless', 'rust', 'wasm', 'postgres', 'redis', 'kafka',
+];
+const IMAGES = [
+  'https://images.unsplash.com/photo-1555066931-4365d14bab8c',
+  'https://images.unsplash.com/photo-1573164713714-d95e436ab8d6',
+  'https://images.unsplash.com/photo-1498050108023-c5249f4df085',
+  'https://images.unsplash.com/photo-1461749280684-dccba630e2f6',
+  'https://images.unsplash.com/photo-1517694712202-14dd9538aa97',
+];
+// Served as-is, without CDN resizing
+const PLAIN_IMAGE = 'https://via.placeholder.com/600x400.png';
+
+const AUTHOR_EXPONENT = 1.1;
+const ACTIVITY_EXPONENT = 0.9; // Who likes and comments
+const WORD_EXPONENT = 1.0;
+const LIKE_SCALE = 4;
+const LIKE_ALPHA = 1.3;
+const CACHED_USERS = 10000; // Author objects kept for the most prolific users
+const MAX_COMMENTS = 500; // Per post
+
+// Random streams per entity
+const POST_STREAM = 0;
+const TEXT_STREAM = 1;
+const LIKER_STREAM = 2;
+const COMMENT_STREAM = 3;
+const USER_STREAM = 4;
+
+const DAY_MS = 24 * 60 * 60 * 1000;
+
+export function userId(index: number): string {
+  return `user-${index}`;
+}
+
+export function postId(index: number): string {
+  return `post-${index}`;
+}
+
+export class DatasetGenerator {
+  readonly seed: number;
+  readonly userCount: number;
+  readonly postCount: number;
+  private readonly imageRatio: number;
+  private readonly maxLikes: number;
+  private readonly withComments: boolean;
+  private readonly start: number;
+  private readonly slotMs: number;
+  private readonly pickAuthor: (random: () => number) => number;
+  private readonly pickActiveUser: (random: () => number) => number;
+  private readonly pickWord: (random: () => number) => number;
+  private postsByUser: Uint32Array | null = null;
+  private likesByUser: Uint32Array | null = null;
+  private authors: User[] = [];
+
+  constructor(options: DatasetOptions = {}) {
+    this.seed = options.seed === undefined ? 1 : options.seed;
+    this.userCount = Math.max(1, options.users || 1000);
+    this.postCount = options.posts === undefined ? 10000 : options.posts;
+    this.imageRatio = options.imageRatio === undefined ? 0.35 : options.imageRatio;
+    this.maxLikes = Math.min(this.userCount, options.maxLikes || 100000);
+    this.withComments = options.comments !== false;
+    this.start = Date.parse(options.start || '2024-01-01T00:00:00Z');
+    this.slotMs = ((options.days || 365) * DAY_MS) / Math.max(1, this.postCount);
+    this.pickAuthor = createZipf(this.userCount, AUTHOR_EXPONENT);
+    this.pickActiveUser = createZipf(this.userCount, ACTIVITY_EXPONENT);
+    this.pickWord = createZipf(VOCABULARY.length, WORD_EXPONENT);
+  }
+
+  // Author index and like count of post `index` (the first draws of its stream)
+  private postShape(index: number): { random: () => number; author: number; likes: number } {
+    const random = createRandom(entitySeed(this.seed, index, POST_STREAM));
+    const author = this.pickAuthor(random);
+    const likes = Math.min(this.maxLikes, Math.floor(pareto(random, LIKE_SCALE, LIKE_ALPHA)));
+    return { random, author, likes };
+  }
+
+  // Per-user totals, so users carry exact postsCount and likesReceived
+  private tally(): void {
+    if (this.postsByUser) {
+      return;
+    }
+    this.postsByUser = new Uint32Array(this.userCount);
+    this.likesByUser = new Uint32Array(this.userCount);
+    for (let i = 0; i < this.postCount; i++) {
+      const { author, likes } = this.postShape(i);
+      this.postsByUser[author]++;
+      (this.likesByUser as Uint32Array)[author] += likes;
+    }
+  }
+
+  user(index: number): User {
+    if (index < this.authors.length && this.authors[index]) {
+      return this.authors[index];
+    }
+    this.tally();
+    const random = createRandom(entitySeed(this.seed, index, USER_STREAM));
+    const first = FIRST_NAMES[Math.floor(random() * FIRST_NAMES.length)];
+    const last = LAST_NAMES[Math.floor(random() * LAST_NAMES.length)];
+    const user: User = {
+      id: userId(index),
+      name: `${first} ${last}`,
+      email: `${first}.${last}.${index}@example.com`.toLowerCase(),
+      createdAt: new Date(this.start - Math.floor(random() * 365) * DAY_MS).toISOString(),
+      postsCount: (this.postsByUser as Uint32Array)[index],
+      likesReceived: (this.likesByUser as Uint32Array)[index],
+    };
+    if (index < CACHED_USERS) {
+      this.authors[index] = user;
+    }
+    return user;
+  }
+
+  private words(random: () => number, count: number): string {
+    const words: string[] = [];
+    for (let i = 0; i < count; i++) {
+      words.push(VOCABULARY[this.pickWord(random)]);
+    }
+    return words.join(' ');
+  }
+
+  post(index: number): Post {
+    const { random, author, likes } = this.postShape(index);
+    const createdAt = new Date(this.start + Math.floor((index + random()) * this.slotMs)).toISOString();
+
+    let imageUrl: string | undefined;
+    if (random() < this.imageRatio) {
+      imageUrl = random() < 0.9 ? `${IMAGES[Math.floor(random() * IMAGES.length)]}?w=800` : PLAIN_IMAGE;
+    }
+
+    const text = createRandom(entitySeed(this.seed, index, TEXT_STREAM));
+    const title = this.words(text, 3 + Math.floor(text() * 6));
+    // Mostly short posts, with a long tail of essays
+    const contentWords = Math.min(800, 12 + Math.floor(pareto(text, 30, 1.8)));
+    let content = this.words(text, contentWords);
+    // Keep to what the API accepts, so posts can be replayed through it
+    if (content.length > MAX_CONTENT_LENGTH) {
+      content = content.slice(0, content.lastIndexOf(' ', MAX_CONTENT_LENGTH));
+    }
+
+    return {
+      id: postId(index),
+      title: title.charAt(0).toUpperCase() + title.slice(1),
+      content,
+      authorId: userId(author),
+      author: this.user(author),
+      imageUrl,
+      likes,
+      likedBy: this.likers(index, likes),
+      createdAt,
+      updatedAt: createdAt,
+    };
+  }
+
+  // `count` distinct users, mostly the active ones
+  private likers(index: number, count: number): string[] {
+    const random = createRandom(entitySeed(this.seed, index, LIKER_STREAM));
+    const likedBy: string[] = [];
+
+    // Liked by most users: a contiguous run of them is just as good, in O(count)
+    if (count * 2 > this.userCount) {
+      const first = Math.floor(random() * this.userCount);
+      for (let i = 0; i < count; i++) {
+        likedBy.push(userId((first + i) % this.userCount));
+      }
+      return likedBy;
+    }
+
+    const seen = new Set<number>();
+    for (let i = 0; i < count; i++) {
+      let liker = this.pickActiveUser(random);
+      // On a repeat, anyone; at most half the users are taken, so this
+      // takes two tries on average
+      while (seen.has(liker)) {
+        liker = Math.floor(random() * this.userCount);
+      }
+      seen.add(liker);
+      likedBy.push(userId(liker));
+    }
+    return likedBy;
+  }
+
+  comments(post: Post, index: number): GeneratedComment[] {
+    if (!this.withComments) {
+      return [];
+    }
+    const random = createRandom(entitySeed(this.seed, index, COMMENT_STREAM));
+    // Busier posts get more comments
+    const count = Math.min(MAX_COMMENTS, Math.floor(pareto(random, 0.5, 1.5) + post.likes * 0.05 * random()));
+    const comments: GeneratedComment[] = [];
+    const posted = Date.parse(post.createdAt);
+
+    for (let i = 0; i < count; i++) {
+      comments.push({
+        id: `${post.id}-c${i}`,
+        postId: post.id,
+        authorId: userId(this.pickActiveUser(random)),
+        content: this.words(random, Math.min(200, 3 + Math.floor(pareto(random, 6, 2)))),
+        // Most replies come within minutes, some weeks later
+        createdAt: new Date(posted + Math.min(30 * DAY_MS, Math.floor(pareto(random, 60000, 0.8)))).toISOString(),
+      });
+    }
+    return comments;
+  }
+
+  // Emits every record in order. When `emit` returns a promise (e.g. a
+  // full write stream), generation waits for it.
+  async generate(emit: (record: DatasetRecord) => void | Promise<void>): Promise<DatasetStats> {
+    const stats: DatasetStats = { users: 0, posts: 0, likes: 0, comments: 0 };
+
+    for (let i = 0; i < this.userCount; i++) {
+      const pending = emit({ type: 'user', user: this.user(i) });
+      if (pending) {
+        await pending;
+      }
+      stats.users++;
+    }
+
+    for (let i = 0; i < this.postCount; i++) {
+      const post = this.post(i);
+      let pending = emit({ type: 'post', post });
+      if (pending) {
+        await pending;
+      }
+      stats.posts++;
+      stats.likes += post.likes;
+
+      const comments = this.comments(post, i);
+      for (let j = 0; j < comments.length; j++) {
+        pending = emit({ type: 'comment', comment: comments[j] });
+        if (pending) {
+          await pending;
+        }
+      }
+      stats.comments += comments.length;
+    }
+
+    return stats;
+  }
+}
@@ -0,0 +1,173 @@
+import { Post, PostFilters } from '@/types';
+
+// Memoized filter/sort pipeline for the feed on the home page.
+//
+// - Derived values (timestamp, lowercased search text) are computed once per
+//   post object and cached in WeakMaps, so comparators never build Dates.
+// - Same posts + same filters returns the previous array (stable identity).
+// - Typing more characters into the search box only re-filters the previous
+//   result, which is already sorted.
+// - When a few posts change (like, edit, create, delete) the previous result
+//   is patched with binary-search removals/inserts instead of re-sorting.
+
+// Past this many changed posts a full recompute is cheaper than patching
+const MAX_INCREMENTAL_CHANGES = 64;
+
+const timestamps = new WeakMap<Post, number>();
+const searchTexts = new WeakMap<Post, string>();
+
+export function postTimestamp(post: Post): number {
+  let time = timestamps.get(post);
+  if (time === undefined) {
+    time = Date.parse(post.createdAt);
+    timestamps.set(post, time);
+  }
+  return time;
+}
+
+function searchText(post: Post): string {
+  let text = searchTexts.get(post);
+  if (text === undefined) {
+    text = `${post.title}\n${post.content}\n${post.author.name}`.toLowerCase();
+    searchTexts.set(post, text);
+  }
+  return text;
+}
+
+type Comparator = (a: Post, b: Post) => number;
+
+export function feedComparator(filters: PostFilters): Comparator {
+  const direction = filters.sortOrder === 'asc' ? 1 : -1;
+  const byId = (a: Post, b: Post) => (a.id < b.id ? -1 : a.id > b.id ? 1 : 0);
+
+  if (filters.sortBy === 'popularity') {
+    return (a, b) => (a.likes - b.likes || postTimestamp(a) - postTimestamp(b) || byId(a, b)) * direction;
+  }
+  return (a, b) => (postTimestamp(a) - postTimestamp(b) || byId(a, b)) * direction;
+}
+
+export function feedPredicate(filters: PostFilters): (post: Post) => boolean {
+  const search = (filters.search || '').toLowerCase();
+  const { authorId } = filters;
+
+  return post => {
+    if (authorId && post.authorId !== authorId) {
+      return false;
+    }
+    return !search || searchText(post).indexOf(search) !== -1;
+  };
+}
+
+function sameOrdering(a: PostFilters, b: PostFilters): boolean {
+  return a.sortBy === b.sortBy && a.sortOrder === b.sortOrder && a.authorId === b.authorId;
+}
+
+function sameFilters(a: PostFilters, b: PostFilters): boolean {
+  return sameOrdering(a, b) && (a.search || '') === (b.search || '');
+}
+
+// Index of `post` in sorted `list`, or where it would be inserted
+function lowerBound(list: Post[], post: Post, compare: Comparator): number {
+  let low = 0;
+  let high = list.length;
+  while (low < high) {
+    const mid = (low + high) >>> 1;
+    if (compare(list[mid], post) < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+// Patch a sorted result with the posts that differ between two snapshots of
+// the store. Returns null when too much changed to be worth patching.
+function patchResult(
+  previousPosts: Post[],
+  posts: Post[],
+  previousResult: Post[],
+  filters: PostFilters
+): Post[] | null {
+  if (Math.abs(posts.length - previousPosts.length) > MAX_INCREMENTAL_CHANGES) {
+    return null;
+  }
+
+  const previousById = new Map<string, Post>();
+  previousPosts.forEach(post => previousById.set(post.id, post));
+
+  const removed: Post[] = [];
+  const added: Post[] = [];
+
+  for (let i = 0; i < posts.length; i++) {
+    const post = posts[i];
+    const previous = previousById.get(post.id);
+    if (previous !== post) {
+      added.push(post);
+      if (previous) {
+        removed.push(previous);
+      }
+      if (added.length > MAX_INCREMENTAL_CHANGES) {
+        return null;
+      }
+    }
+    previousById.delete(post.id);
+  }
+  // Whatever is left was deleted from the store
+  previousById.forEach(post => removed.push(post));
+
+  if (removed.length > MAX_INCREMENTAL_CHANGES) {
+    return null;
+  }
+
+  const compare = feedComparator(filters);
+  const matches = feedPredicate(filters);
+  const result = previousResult.slice();
+
+  removed.forEach(post => {
+    const index = lowerBound(result, post, compare);
+    if (result[index] === post) {
+      result.splice(index, 1);
+    }
+  });
+
+  added.forEach(post => {
+    if (matches(post)) {
+      result.splice(lowerBound(result, post, compare), 0, post);
+    }
+  });
+
+  return result;
+}
+
+export function createFeedSelector() {
+  let lastPosts: Post[] | null = null;
+  let lastFilters: PostFilters | null = null;
+  let lastResult: Post[] = [];
+
+  return function selectFeed(posts: Post[], filters: PostFilters): Post[] {
+    let result: Post[] | null = null;
+
+    if (lastPosts && lastFilters) {
+      if (sameFilters(filters, lastFilters)) {
+        result = posts === lastPosts ? lastResult : patchResult(lastPosts, posts, lastResult, filters);
+      } else if (
+        posts === lastPosts &&
+        sameOrdering(filters, lastFilters) &&
+        (filters.search || '').toLowerCase().indexOf((lastFilters.search || '').toLowerCase()) !== -1
+      ) {
+        // A longer search can only match a subset of what matched before
+        result = lastResult.filter(feedPredicate(filters));
+      }
+    }
+
+    if (!result) {
+      result = posts.filter(feedPredicate(filters)).sort(feedComparator(filters));
+    }
+
+    lastPosts = posts;
+    lastFilters = filters;
+    lastResult = result;
+    return result;
+  };
+}
@@ -0,0 +1,97 @@
+// Responsive image helpers for post images.
+//
+// Images from a resizing CDN (Unsplash/imgix) are requested in a few fixed
+// width buckets, so the browser picks the smallest one that covers the slot
+// and every post reuses the same cached variants. URLs from other hosts are
+// served as-is.
+
+// Width buckets for srcset; the largest covers the feed column at 2x
+export const IMAGE_WIDTHS = [320, 480, 640, 960, 1280, 1600];
+
+// Feed column: full width below the `lg` breakpoint, ~800px beside the sidebar
+export const FEED_IMAGE_SIZES = '(min-width: 62em) 800px, 100vw';
+
+// Start loading images this far before they scroll into view
+export const PREFETCH_MARGIN = '1200px 0px';
+
+const RESIZABLE_HOSTS = ['images.unsplash.com'];
+
+function parse(url: string): URL | null {
+  try {
+    return new URL(url);
+  } catch (error) {
+    return null;
+  }
+}
+
+export function isResizable(url: string): boolean {
+  const parsed = parse(url);
+  return parsed !== null && RESIZABLE_HOSTS.indexOf(parsed.hostname) !== -1;
+}
+
+export interface VariantOptions {
+  quality?: number;
+  format?: 'jpg' | 'png' | 'webp'; // Default: best format the browser accepts
+}
+
+// `url` resized to `width` pixels (original URL if the host cannot resize)
+export function imageVariant(url: string, width: number, options: VariantOptions = {}): string {
+  const parsed = parse(url);
+  if (!parsed || RESIZABLE_HOSTS.indexOf(parsed.hostname) === -1) {
+    return url;
+  }
+  parsed.searchParams.set('w', String(width));
+  parsed.searchParams.set('q', String(options.quality || 70));
+  parsed.searchParams.set('fit', 'max');
+  if (options.format) {
+    parsed.searchParams.set('fm', options.format);
+  } else {
+    parsed.searchParams.set('auto', 'format');
+  }
+  return parsed.toString();
+}
+
+// srcset over the width buckets, or undefined when the host cannot resize
+export function buildSrcSet(url: string, widths: number[] = IMAGE_WIDTHS): string | undefined {
+  if (!isResizable(url)) {
+    return undefined;
+  }
+  return widths.map(width => `${imageVariant(url, width)} ${width}w`).join(', ');
+}
+
+// Shared IntersectionObserver: calls `callback` once, when `element` comes
+// within PREFETCH_MARGIN of the viewport. Returns the function that stops
+// watching. Without IntersectionObserver the callback runs at once.
+const watched = new Map<Element, () => void>();
+let nearObserver: IntersectionObserver | null = null;
+
+export function whenNearViewport(element: Element, callback: () => void): () => void {
+  if (typeof IntersectionObserver === 'undefined') {
+    callback();
+    return () => undefined;
+  }
+
+  if (!nearObserver) {
+    nearObserver = new IntersectionObserver(
+      entries => {
+        entries.forEach(entry => {
+          const near = watched.get(entry.target);
+          if (near && entry.isIntersecting) {
+            watched.delete(entry.target);
+            (nearObserver as IntersectionObserver).unobserve(entry.target);
+            near();
+          }
+        });
+      },
+      { rootMargin: PREFETCH_MARGIN }
+    );
+  }
+
+  watched.set(element, callback);
+  nearObserver.observe(element);
+  return () => {
+    if (watched.delete(element) && nearObserver) {
+      nearObserver.unobserve(element);
+    }
+  };
+}
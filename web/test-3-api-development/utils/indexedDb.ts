@@ -0,0 +1,55 @@
+// Minimal promise wrapper over a single IndexedDB object store of
+// [key, value] rows, shared by the response cache and the outbox
+
+export interface KeyValueStore<T> {
+  entries(): Promise<[string, T][]>;
+  put(key: string, value: T): Promise<void>;
+  remove(keys: string[]): Promise<void>;
+}
+
+export function openKeyValueStore<T>(name: string, storeName: string): KeyValueStore<T> {
+  let database: Promise<IDBDatabase> | null = null;
+
+  const open = () => {
+    if (!database) {
+      database = new Promise((resolve, reject) => {
+        const request = indexedDB.open(name, 1);
+        request.onupgradeneeded = () => {
+          request.result.createObjectStore(storeName);
+        };
+        request.onsuccess = () => resolve(request.result);
+        request.onerror = () => reject(request.error);
+      });
+    }
+    return database;
+  };
+
+  const transaction = (mode: IDBTransactionMode, run: (store: IDBObjectStore) => void) =>
+    open().then(
+      db =>
+        new Promise<void>((resolve, reject) => {
+          const tx = db.transaction(storeName, mode);
+          run(tx.objectStore(storeName));
+          tx.oncomplete = () => resolve();
+          tx.onerror = () => reject(tx.error);
+        })
+    );
+
+  return {
+    entries: () => {
+      const rows: [string, T][] = [];
+      return transaction('readonly', store => {
+        const cursor = store.openCursor();
+        cursor.onsuccess = () => {
+          const current = cursor.result;
+          if (current) {
+            rows.push([String(current.key), current.value as T]);
+            current.continue();
+          }
+        };
+      }).then(() => rows);
+    },
+    put: (key, value) => transaction('readwrite', store => store.put(value, key)),
+    remove: keys => transaction('readwrite', store => keys.forEach(key => store.delete(key))),
+  };
+}
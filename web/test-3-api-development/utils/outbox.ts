@@ -0,0 +1,319 @@
+// Durable queue of post writes made while offline (or before the server
+// confirmed them), replayed through POST /api/posts/mutations.
+//
+// - The store applies each write optimistically and enqueues it here; the
+//   queue is mirrored to IndexedDB so it survives reloads.
+// - Every mutation carries an idempotency key. A batch whose response was
+//   lost can be resent (even by another tab sharing the queue) without
+//   applying anything twice.
+// - Writes are squashed while they wait: a like then an unlike cancels out,
+//   edits merge into the pending create or edit, and deleting a post that
+//   was never sent drops everything queued for it.
+// - Draining sends the whole queue as one request (in chunks of
+//   `maxBatch`). Mutations already on the wire are never squashed into.
+
+import { MutationBatch, MutationResult, PostMutation } from '@/types';
+import { openKeyValueStore } from './indexedDb';
+import { postsApi } from './api';
+
+type WithoutKey<T> = T extends unknown ? Omit<T, 'key'> : never;
+export type NewMutation = WithoutKey<PostMutation>;
+
+// `order` keeps the queue order across reloads
+export type QueuedMutation = PostMutation & { order: number };
+
+// Storage the queue is mirrored to; every method is best effort
+export interface OutboxPersistence {
+  load(): Promise<QueuedMutation[]>;
+  save(mutation: QueuedMutation): Promise<void>;
+  remove(keys: string[]): Promise<void>;
+}
+
+export interface OutboxOptions {
+  send: (mutations: PostMutation[]) => Promise<MutationResult[]>;
+  persistence?: OutboxPersistence;
+  maxBatch?: number;
+  now?: () => number;
+}
+
+export type OutboxListener = (result: MutationResult, mutation: PostMutation) => void;
+
+let keyCounter = 0;
+
+function idempotencyKey(): string {
+  return `${Date.now().toString(36)}-${(++keyCounter).toString(36)}-${Math.random().toString(36).slice(2, 10)}`;
+}
+
+export class Outbox {
+  // Resolves once persisted mutations (if any) have been loaded
+  readonly ready: Promise<void>;
+
+  private queue: QueuedMutation[] = [];
+  // Keys of mutations currently being sent
+  private inflight = new Set<string>();
+  private draining: Promise<void> | null = null;
+  private drainQueued = false;
+  private lastOrder = 0;
+  private listeners = new Set<OutboxListener>();
+  private stopListening: (() => void) | null = null;
+  private forward: ((mutation: QueuedMutation) => void) | null = null;
+  private readonly options: Required<Omit<OutboxOptions, 'persistence'>> &
+    Pick<OutboxOptions, 'persistence'>;
+
+  constructor(options: OutboxOptions) {
+    this.options = { maxBatch: 100, now: Date.now, ...options };
+
+    this.ready = this.reload();
+  }
+
+  // Merge in what is persisted (e.g. queued by a tab that has since closed)
+  reload(): Promise<void> {
+    const persistence = this.options.persistence;
+    if (!persistence) {
+      return Promise.resolve();
+    }
+    return persistence.load().then(
+      loaded => {
+        const known = new Set(this.queue.map(mutation => mutation.key));
+        this.queue = this.queue
+          .concat(loaded.filter(mutation => !known.has(mutation.key)))
+          .sort((a, b) => a.order - b.order);
+        this.lastOrder = this.queue.reduce((max, mutation) => Math.max(max, mutation.order), this.lastOrder);
+      },
+      () => undefined
+    );
+  }
+
+  get size(): number {
+    return this.queue.length;
+  }
+
+  get pending(): PostMutation[] {
+    return this.queue.map(strip);
+  }
+
+  hasPending(postId: string): boolean {
+    return this.queue.some(mutation => mutation.postId === postId);
+  }
+
+  onResult(listener: OutboxListener): () => void {
+    this.listeners.add(listener);
+    return () => {
+      this.listeners.delete(listener);
+    };
+  }
+
+  // Hand new mutations to `target` instead of queuing them here (a follower
+  // tab sends its writes to the leader); null queues locally again.
+  // Forwarded mutations are persisted first, so a write survives even if
+  // the leader never gets it (it closed, or the election had not settled):
+  // the next leader picks it up with reload().
+  forwardTo(target: ((mutation: QueuedMutation) => void) | null): void {
+    this.forward = target;
+  }
+
+  // Queue a mutation another tab already keyed and persisted (no-op when
+  // it is already queued here)
+  adopt(mutation: QueuedMutation): void {
+    if (this.queue.some(queued => queued.key === mutation.key)) {
+      return;
+    }
+    this.queue = this.queue.concat(mutation).sort((a, b) => a.order - b.order);
+    this.lastOrder = Math.max(this.lastOrder, mutation.order);
+    this.persist(persistence => persistence.save(mutation));
+    this.scheduleDrain();
+  }
+
+  enqueue(mutation: NewMutation): void {
+    if (this.forward) {
+      const queued = this.keyed(mutation);
+      const saved = this.options.persistence
+        ? this.options.persistence.save(queued).catch(() => undefined)
+        : Promise.resolve();
+      saved.then(() => {
+        // Became the leader meanwhile: queue it here
+        if (this.forward) {
+          this.forward(queued);
+        } else {
+          this.adopt(queued);
+        }
+      });
+      return;
+    }
+
+    const waiting = (predicate: (queued: QueuedMutation) => boolean) =>
+      this.queue.filter(
+        queued => queued.postId === mutation.postId && !this.inflight.has(queued.key) && predicate(queued)
+      );
+
+    switch (mutation.type) {
+      case 'like': {
+        const [previous] = waiting(queued => queued.type === 'like' && queued.userId === mutation.userId);
+        if (previous) {
+          // Likes always flip the state, so the pair cancels out (a repeat is a no-op)
+          if (previous.type === 'like' && previous.liked !== mutation.liked) {
+            this.removeQueued([previous.key]);
+          }
+          return;
+        }
+        break;
+      }
+
+      case 'update': {
+        const [target] = waiting(queued => queued.type === 'create' || queued.type === 'update');
+        if (target && (target.type === 'create' || target.type === 'update')) {
+          this.replaceQueued({ ...target, data: { ...target.data, ...mutation.data } } as QueuedMutation);
+          return;
+        }
+        break;
+      }
+
+      case 'delete': {
+        const created = waiting(queued => queued.type === 'create').length > 0;
+        this.removeQueued(waiting(queued => created || queued.type !== 'create').map(queued => queued.key));
+        // The server never saw the post: nothing left to send
+        if (created) {
+          return;
+        }
+        break;
+      }
+    }
+
+    const queued = this.keyed(mutation);
+    this.queue.push(queued);
+    this.persist(persistence => persistence.save(queued));
+    this.scheduleDrain();
+  }
+
+  // Send everything queued. Mutations stay queued until the server gives a
+  // final answer (anything but a network error or a 5xx).
+  drain(): Promise<void> {
+    if (!this.draining) {
+      const done = () => {
+        this.draining = null;
+      };
+      this.draining = this.ready.then(() => this.drainQueue()).then(done, done);
+    }
+    return this.draining;
+  }
+
+  // Drain now, whenever the browser comes back online, and shortly after
+  // each enqueue while online. Returns the function that stops it.
+  start(): () => void {
+    if (!this.stopListening) {
+      const online = () => {
+        this.drain();
+      };
+      if (typeof window !== 'undefined') {
+        window.addEventListener('online', online);
+      }
+      this.stopListening = () => {
+        if (typeof window !== 'undefined') {
+          window.removeEventListener('online', online);
+        }
+        this.stopListening = null;
+      };
+      this.drain();
+    }
+    return () => {
+      if (this.stopListening) {
+        this.stopListening();
+      }
+    };
+  }
+
+  private async drainQueue(): Promise<void> {
+    while (this.queue.length > 0 && !isOffline()) {
+      const batch = this.queue.slice(0, this.options.maxBatch);
+      batch.forEach(mutation => this.inflight.add(mutation.key));
+
+      let results: MutationResult[];
+      try {
+        results = await this.options.send(batch.map(strip));
+      } catch (error) {
+        // Still queued; the next drain (reconnect or enqueue) retries
+        this.inflight.clear();
+        return;
+      }
+      this.inflight.clear();
+
+      const byKey = new Map<string, MutationResult>();
+      results.forEach(result => byKey.set(result.key, result));
+      const settled = batch.filter(mutation => {
+        const result = byKey.get(mutation.key);
+        return result !== undefined && result.status < 500;
+      });
+
+      this.removeQueued(settled.map(mutation => mutation.key));
+      settled.forEach(mutation => {
+        const result = byKey.get(mutation.key) as MutationResult;
+        this.listeners.forEach(listener => listener(result, strip(mutation)));
+      });
+
+      if (settled.length < batch.length) {
+        // The server is struggling; leave the rest for the next drain
+        return;
+      }
+    }
+  }
+
+  private keyed(mutation: NewMutation): QueuedMutation {
+    this.lastOrder = Math.max(this.options.now(), this.lastOrder + 1);
+    return { ...mutation, key: idempotencyKey(), order: this.lastOrder } as QueuedMutation;
+  }
+
+  // Enqueues in the same tick share one request
+  private scheduleDrain(): void {
+    if (!this.stopListening || this.drainQueued) {
+      return;
+    }
+    this.drainQueued = true;
+    Promise.resolve().then(() => {
+      this.drainQueued = false;
+      this.drain();
+    });
+  }
+
+  private replaceQueued(mutation: QueuedMutation): void {
+    this.queue = this.queue.map(queued => (queued.key === mutation.key ? mutation : queued));
+    this.persist(persistence => persistence.save(mutation));
+  }
+
+  private removeQueued(keys: string[]): void {
+    if (keys.length === 0) {
+      return;
+    }
+    this.queue = this.queue.filter(queued => keys.indexOf(queued.key) === -1);
+    this.persist(persistence => persistence.remove(keys));
+  }
+
+  private persist(write: (persistence: OutboxPersistence) => Promise<void>): void {
+    if (this.options.persistence) {
+      write(this.options.persistence).catch(() => undefined);
+    }
+  }
+}
+
+function strip(mutation: QueuedMutation): PostMutation {
+  const { order, ...rest } = mutation;
+  return rest as PostMutation;
+}
+
+function isOffline(): boolean {
+  return typeof navigator !== 'undefined' && navigator.onLine === false;
+}
+
+// IndexedDB mirror: one object store of [key, mutation] rows
+export function createIndexedDbOutbox(name: string): OutboxPersistence {
+  const store = openKeyValueStore<QueuedMutation>(name, 'mutations');
+  return {
+    load: () => store.entries().then(rows => rows.map(row => row[1])),
+    save: mutation => store.put(mutation.key, mutation),
+    remove: keys => store.remove(keys),
+  };
+}
+
+export const postsOutbox = new Outbox({
+  send: mutations => postsApi.mutate(mutations).then(response => (response.data as MutationBatch).results),
+  persistence: typeof indexedDB === 'undefined' ? undefined : createIndexedDbOutbox('posts-outbox'),
+});
@@ -0,0 +1,146 @@
+// Building blocks for resilient requests: backoff delays, abortable sleeps,
+// deadlines and a circuit breaker. utils/api.ts wires them into apiRequest.
+
+// "Full jitter" backoff: a uniform delay in [0, min(cap, base * 2^attempt)).
+// Randomizing the whole interval spreads retries from many clients out
+// instead of having them hit a recovering server in synchronized waves.
+export function backoffDelay(
+  attempt: number,
+  baseDelay: number,
+  maxDelay: number,
+  random: () => number = Math.random
+): number {
+  const ceiling = Math.min(maxDelay, baseDelay * Math.pow(2, attempt));
+  return Math.floor(random() * ceiling);
+}
+
+export class AbortError extends Error {
+  constructor(message = 'The operation was aborted') {
+    super(message);
+    this.name = 'AbortError';
+  }
+}
+
+// Resolves after `ms`, or rejects as soon as `signal` aborts
+export function sleep(ms: number, signal?: AbortSignal): Promise<void> {
+  return new Promise((resolve, reject) => {
+    if (signal && signal.aborted) {
+      reject(new AbortError());
+      return;
+    }
+    const onAbort = () => {
+      clearTimeout(timer);
+      reject(new AbortError());
+    };
+    const timer = setTimeout(() => {
+      if (signal) {
+        signal.removeEventListener('abort', onAbort);
+      }
+      resolve();
+    }, ms);
+    if (signal) {
+      signal.addEventListener('abort', onAbort);
+    }
+  });
+}
+
+// An AbortController that fires after `timeout` ms or when `parent` aborts,
+// whichever comes first. Call `clear()` once the work is done.
+export function deadline(timeout: number, parent?: AbortSignal | null) {
+  const controller = new AbortController();
+  const abort = () => controller.abort();
+  const timer = setTimeout(abort, timeout);
+
+  if (parent) {
+    if (parent.aborted) {
+      abort();
+    } else {
+      parent.addEventListener('abort', abort);
+    }
+  }
+
+  return {
+    signal: controller.signal,
+    expiresAt: Date.now() + timeout,
+    clear: () => {
+      clearTimeout(timer);
+      if (parent) {
+        parent.removeEventListener('abort', abort);
+      }
+    },
+  };
+}
+
+export type CircuitState = 'closed' | 'open' | 'half-open';
+
+export interface CircuitBreakerOptions {
+  failureThreshold?: number; // consecutive failures that open the circuit
+  cooldown?: number; // ms to fail fast before letting a probe through
+  now?: () => number;
+}
+
+// Classic three-state breaker. Closed: requests flow and consecutive
+// failures are counted. Open: requests fail fast until the cooldown ends.
+// Half-open: one probe goes through; success closes the circuit, failure
+// opens it again for another cooldown.
+export class CircuitBreaker {
+  private failures = 0;
+  private openedAt = 0;
+  private probing = false;
+  private current: CircuitState = 'closed';
+  private readonly failureThreshold: number;
+  private readonly cooldown: number;
+  private readonly now: () => number;
+
+  constructor(options: CircuitBreakerOptions = {}) {
+    this.failureThreshold = options.failureThreshold || 5;
+    this.cooldown = options.cooldown === undefined ? 10000 : options.cooldown;
+    this.now = options.now || Date.now;
+  }
+
+  get state(): CircuitState {
+    if (this.current === 'open' && this.now() - this.openedAt >= this.cooldown) {
+      this.current = 'half-open';
+      this.probing = false;
+    }
+    return this.current;
+  }
+
+  // Whether a request may go out now. In half-open state only the first
+  // caller gets through; the rest fail fast until the probe settles.
+  allow(): boolean {
+    switch (this.state) {
+      case 'closed':
+        return true;
+      case 'half-open':
+        if (this.probing) {
+          return false;
+        }
+        this.probing = true;
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  success(): void {
+    this.failures = 0;
+    this.probing = false;
+    this.current = 'closed';
+  }
+
+  // The request was abandoned by its caller: says nothing about the
+  // endpoint, but a half-open probe must hand its slot back
+  cancel(): void {
+    this.probing = false;
+  }
+
+  failure(): void {
+    this.failures++;
+    this.probing = false;
+    if (this.current === 'half-open' || this.failures >= this.failureThreshold) {
+      this.current = 'open';
+      this.openedAt = this.now();
+    }
+  }
+}
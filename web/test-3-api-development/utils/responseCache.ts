@@ -0,0 +1,216 @@
+// Client-side stale-while-revalidate cache for GET responses, keyed by URL.
+//
+// - Entries younger than `ttl` are served as-is (hit).
+// - Older entries are served immediately and refreshed in the background
+//   (stale hit); subscribers are told when the fresh value lands.
+// - Bounded by entry count and by approximate bytes, evicting least recently
+//   used entries first (Map iteration order is insertion order, and a read
+//   re-inserts the entry at the end).
+// - Optionally mirrored to IndexedDB so a repeat visit can render from cache
+//   before the network answers.
+
+import { openKeyValueStore } from './indexedDb';
+
+export interface CacheStats {
+  hits: number;
+  staleHits: number;
+  misses: number;
+  revalidations: number;
+  evictions: number;
+}
+
+export interface CacheEntry<T = unknown> {
+  value: T;
+  storedAt: number;
+  size: number;
+}
+
+// Storage the cache is mirrored to; every method is best effort
+export interface CachePersistence {
+  load(): Promise<[string, CacheEntry][]>;
+  save(key: string, entry: CacheEntry): Promise<void>;
+  remove(keys: string[]): Promise<void>;
+}
+
+export interface ResponseCacheOptions {
+  ttl?: number; // ms an entry is served without revalidating
+  maxEntries?: number;
+  maxBytes?: number;
+  persistence?: CachePersistence;
+  now?: () => number;
+}
+
+type CacheListener = (key: string, value: unknown) => void;
+
+export class ResponseCache {
+  readonly stats: CacheStats = { hits: 0, staleHits: 0, misses: 0, revalidations: 0, evictions: 0 };
+  // Resolves once persisted entries (if any) have been loaded
+  readonly ready: Promise<void>;
+
+  private entries = new Map<string, CacheEntry>();
+  private bytes = 0;
+  // Bumped by invalidate(), so responses fetched before it are discarded
+  private generation = 0;
+  private listeners = new Set<CacheListener>();
+  private revalidating = new Set<string>();
+  private readonly ttl: number;
+  private readonly maxEntries: number;
+  private readonly maxBytes: number;
+  private readonly persistence: CachePersistence | null;
+  private readonly now: () => number;
+
+  constructor(options: ResponseCacheOptions = {}) {
+    this.ttl = options.ttl === undefined ? 30000 : options.ttl;
+    this.maxEntries = options.maxEntries || 200;
+    this.maxBytes = options.maxBytes || 5 * 1024 * 1024;
+    this.persistence = options.persistence || null;
+    this.now = options.now || Date.now;
+
+    this.ready = this.persistence
+      ? this.persistence.load().then(
+          loaded => {
+            loaded.forEach(([key, entry]) => {
+              // Anything fetched meanwhile is newer than the persisted copy
+              if (!this.entries.has(key)) {
+                this.store(key, entry, false);
+              }
+            });
+          },
+          () => undefined
+        )
+      : Promise.resolve();
+  }
+
+  get size(): number {
+    return this.entries.size;
+  }
+
+  get byteSize(): number {
+    return this.bytes;
+  }
+
+  // Serve `key` from cache when possible, otherwise (or additionally, when
+  // stale) load it with `fetcher`
+  async get<T>(key: string, fetcher: () => Promise<T>): Promise<T> {
+    await this.ready;
+
+    const entry = this.entries.get(key) as CacheEntry<T> | undefined;
+    if (!entry) {
+      this.stats.misses++;
+      return this.load(key, fetcher);
+    }
+
+    // Re-insert to mark as most recently used
+    this.entries.delete(key);
+    this.entries.set(key, entry);
+
+    if (this.now() - entry.storedAt < this.ttl) {
+      this.stats.hits++;
+    } else {
+      this.stats.staleHits++;
+      this.revalidate(key, fetcher);
+    }
+    return entry.value;
+  }
+
+  // Drop every entry whose key starts with `prefix` (all entries by default)
+  invalidate(prefix = ''): void {
+    this.generation++;
+    const removed: string[] = [];
+    this.entries.forEach((entry, key) => {
+      if (key.indexOf(prefix) === 0) {
+        removed.push(key);
+      }
+    });
+    removed.forEach(key => this.delete(key));
+    if (removed.length && this.persistence) {
+      this.persistence.remove(removed).catch(() => undefined);
+    }
+  }
+
+  // Notified whenever a background revalidation brings a new value
+  subscribe(listener: CacheListener): () => void {
+    this.listeners.add(listener);
+    return () => {
+      this.listeners.delete(listener);
+    };
+  }
+
+  private async load<T>(key: string, fetcher: () => Promise<T>): Promise<T> {
+    const generation = this.generation;
+    const value = await fetcher();
+    if (generation === this.generation) {
+      this.set(key, value);
+    }
+    return value;
+  }
+
+  private revalidate<T>(key: string, fetcher: () => Promise<T>): void {
+    if (this.revalidating.has(key)) {
+      return;
+    }
+    this.revalidating.add(key);
+    this.stats.revalidations++;
+
+    this.load(key, fetcher).then(
+      value => {
+        this.revalidating.delete(key);
+        this.listeners.forEach(listener => listener(key, value));
+      },
+      () => {
+        // The stale value was already served; the next read tries again
+        this.revalidating.delete(key);
+      }
+    );
+  }
+
+  private set(key: string, value: unknown): void {
+    // Approximate: UTF-16 length of the JSON the value came from
+    const entry: CacheEntry = { value, storedAt: this.now(), size: JSON.stringify(value).length * 2 };
+    if (entry.size > this.maxBytes) {
+      return;
+    }
+    this.store(key, entry, true);
+  }
+
+  private store(key: string, entry: CacheEntry, persist: boolean): void {
+    this.delete(key);
+    this.entries.set(key, entry);
+    this.bytes += entry.size;
+
+    const evicted: string[] = [];
+    while (this.entries.size > this.maxEntries || this.bytes > this.maxBytes) {
+      const oldest = this.entries.keys().next().value as string;
+      this.delete(oldest);
+      evicted.push(oldest);
+      this.stats.evictions++;
+    }
+
+    if (this.persistence) {
+      if (persist) {
+        this.persistence.save(key, entry).catch(() => undefined);
+      }
+      if (evicted.length) {
+        this.persistence.remove(evicted).catch(() => undefined);
+      }
+    }
+  }
+
+  private delete(key: string): void {
+    const entry = this.entries.get(key);
+    if (entry) {
+      this.bytes -= entry.size;
+      this.entries.delete(key);
+    }
+  }
+}
+
+// IndexedDB mirror: one object store of [key, entry] rows
+export function createIndexedDbPersistence(name: string): CachePersistence {
+  const store = openKeyValueStore<CacheEntry>(name, 'responses');
+  return {
+    load: () => store.entries().then(rows => rows.sort((a, b) => a[1].storedAt - b[1].storedAt)),
+    save: (key, entry) => store.put(key, entry),
+    remove: keys => store.remove(keys),
+  };
+}
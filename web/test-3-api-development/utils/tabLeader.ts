@@ -0,0 +1,150 @@
+// Leader election among this origin's tabs, plus a message bus between them.
+//
+// Every tab asks for the same Web Lock; the lock manager grants it to one
+// tab at a time, and that tab stays leader until it closes (the browser
+// releases the lock, even on a crash) or calls close(). The next tab in
+// line then becomes leader. Messages go over a BroadcastChannel, which
+// delivers to every other tab but never back to the sender.
+//
+// Without Web Locks (older browsers, tests), each tab leads itself, which
+// is the same as having no coordination at all.
+
+export interface LockManagerLike {
+  request(
+    name: string,
+    options: { signal?: AbortSignal },
+    callback: () => Promise<void>
+  ): Promise<unknown>;
+}
+
+export interface ChannelLike {
+  postMessage(message: unknown): void;
+  onmessage: ((event: { data: unknown }) => void) | null;
+  close(): void;
+}
+
+export interface TabLeaderOptions {
+  locks?: LockManagerLike | null;
+  createChannel?: ((name: string) => ChannelLike) | null;
+}
+
+type LeadershipListener = (leader: boolean) => void;
+
+function defaultLocks(): LockManagerLike | null {
+  const locks = typeof navigator !== 'undefined' && (navigator as Navigator & { locks?: LockManagerLike }).locks;
+  return locks || null;
+}
+
+function defaultChannel(): ((name: string) => ChannelLike) | null {
+  return typeof BroadcastChannel === 'undefined'
+    ? null
+    : name => new BroadcastChannel(name) as unknown as ChannelLike;
+}
+
+export class TabLeader<M> {
+  private leader = false;
+  private started = false;
+  private closed = false;
+  private release: (() => void) | null = null;
+  private abort: AbortController | null = null;
+  private channel: ChannelLike | null = null;
+  private leadershipListeners = new Set<LeadershipListener>();
+  private messageListeners = new Set<(message: M) => void>();
+  private readonly locks: LockManagerLike | null;
+  private readonly createChannel: ((name: string) => ChannelLike) | null;
+
+  constructor(private readonly name: string, options: TabLeaderOptions = {}) {
+    this.locks = options.locks === undefined ? defaultLocks() : options.locks;
+    this.createChannel = options.createChannel === undefined ? defaultChannel() : options.createChannel;
+  }
+
+  get isLeader(): boolean {
+    return this.leader;
+  }
+
+  // Join the election; idempotent
+  start(): void {
+    if (this.started || this.closed) {
+      return;
+    }
+    this.started = true;
+
+    if (this.createChannel) {
+      this.channel = this.createChannel(this.name);
+      this.channel.onmessage = event => {
+        this.messageListeners.forEach(listener => listener(event.data as M));
+      };
+    }
+
+    if (!this.locks) {
+      this.setLeader(true);
+      return;
+    }
+
+    this.abort = typeof AbortController === 'undefined' ? null : new AbortController();
+    this.locks
+      .request(this.name, this.abort ? { signal: this.abort.signal } : {}, () => {
+        if (this.closed) {
+          return Promise.resolve();
+        }
+        // Hold the lock until close()
+        return new Promise<void>(resolve => {
+          this.release = resolve;
+          this.setLeader(true);
+        });
+      })
+      // Rejected when close() aborts a request that was still waiting
+      .catch(() => undefined);
+  }
+
+  onLeadershipChange(listener: LeadershipListener): () => void {
+    this.leadershipListeners.add(listener);
+    return () => {
+      this.leadershipListeners.delete(listener);
+    };
+  }
+
+  onMessage(listener: (message: M) => void): () => void {
+    this.messageListeners.add(listener);
+    return () => {
+      this.messageListeners.delete(listener);
+    };
+  }
+
+  // Send to every other tab
+  post(message: M): void {
+    if (this.channel) {
+      this.channel.postMessage(message);
+    }
+  }
+
+  close(): void {
+    if (this.closed) {
+      return;
+    }
+    this.closed = true;
+    if (this.abort) {
+      this.abort.abort();
+    }
+    if (this.release) {
+      this.release();
+      this.release = null;
+    }
+    this.setLeader(false);
+    if (this.channel) {
+      this.channel.onmessage = null;
+      this.channel.close();
+      this.channel = null;
+    }
+    this.leadershipListeners.clear();
+    this.messageListeners.clear();
+  }
+
+  private setLeader(leader: boolean): void {
+    if (this.leader === leader) {
+      return;
+    }
+    this.leader = leader;
+    this.leadershipListeners.forEach(listener => listener(leader));
+  }
+}
@@ -1,5 +1,9 @@
 // Validation utilities
 
+import { CreatePostData, UpdatePostData } from '@/types';
+import { isResizable } from './images';
+import { compileSchema, StringField } from './schema';
+
 export interface ValidationResult {
   isValid: boolean;
   errors: string[];
@@ -40,6 +44,38 @@ export function validatePost(data: {
   };
 }
 
+// Request body validators for the post endpoints, compiled once
+// (utils/schema.ts). Unlike validatePost they also reject non-string fields.
+
+export const MAX_TITLE_LENGTH = 200;
+export const MAX_CONTENT_LENGTH = 5000;
+export const MAX_IMAGE_URL_LENGTH = 2048;
+
+// A file with an image extension, or any image on a resizing CDN
+// (whose URLs have no extension)
+const IMAGE_FILE_URL = /^https?:\/\/[^\s/?#]+\/[^\s?#]*\.(jpe?g|png|gif|webp)([?#]\S*)?$/i;
+const isImageUrl = (url: string) => IMAGE_FILE_URL.test(url) || isResizable(url);
+
+const imageUrl: StringField = {
+  label: 'Image URL',
+  allowEmpty: true, // '' removes the image
+  maxLength: MAX_IMAGE_URL_LENGTH,
+  format: isImageUrl,
+  formatMessage: 'Image URL must be a valid image URL',
+};
+
+export const checkCreatePost = compileSchema<CreatePostData>({
+  title: { label: 'Title', required: true, maxLength: MAX_TITLE_LENGTH },
+  content: { label: 'Content', required: true, maxLength: MAX_CONTENT_LENGTH },
+  imageUrl,
+});
+
+export const checkUpdatePost = compileSchema<UpdatePostData>({
+  title: { label: 'Title', maxLength: MAX_TITLE_LENGTH },
+  content: { label: 'Content', maxLength: MAX_CONTENT_LENGTH },
+  imageUrl,
+});
+
 export function validateEmail(email: string): boolean {
   const emailPattern = /^[^\s@]+@[^\s@]+\.[^\s@]+$/;
   return emailPattern.test(email);
@@ -0,0 +1,431 @@
+// Client side of the realtime gateway (server/realtime.ts).
+//
+// One RealtimeConnection multiplexes every subscription in the page over a
+// single socket. It is a small state machine:
+//
+//   connecting -> connected -> reconnecting -> connecting -> ...
+//        \-> suspended (tab hidden or browser offline) -> connecting
+//   any state -> closed (close() was called; terminal)
+//
+// - Reconnects use full-jitter exponential backoff, so when a server restart
+//   drops every client at once their reconnects are spread over time
+//   instead of arriving as one storm.
+// - The client PINGs every `heartbeatInterval`; any message counts as a
+//   sign of life, and silence for `heartbeatTimeout` drops the socket.
+// - A tab hidden for longer than `hiddenGracePeriod` closes its socket and
+//   reconnects when it becomes visible again.
+// - Each connection attempt carries a generation number; events from a
+//   socket that has since been replaced are ignored, so overlapping
+//   connections can never both be live.
+
+import { ClientMessage, WebSocketMessage } from '@/types/websocket';
+import { backoffDelay } from './resilience';
+
+export type ConnectionState = 'connecting' | 'connected' | 'reconnecting' | 'suspended' | 'closed';
+
+export type MessageListener = (message: WebSocketMessage) => void;
+export type StateListener = (state: ConnectionState) => void;
+
+// Minimal WebSocket surface, so tests can supply a fake
+export interface WebSocketLike {
+  readyState: number;
+  onopen: ((event: unknown) => void) | null;
+  onclose: ((event: unknown) => void) | null;
+  onerror: ((event: unknown) => void) | null;
+  onmessage: ((event: { data: unknown }) => void) | null;
+  send(data: string): void;
+  close(code?: number, reason?: string): void;
+}
+
+export interface RealtimeConnectionOptions {
+  url: string;
+  // Called before each attempt (e.g. to attach the gateway); failures count
+  // as a failed attempt
+  prepare?: () => Promise<unknown>;
+  createSocket?: (url: string) => WebSocketLike;
+  baseDelay?: number;
+  maxDelay?: number;
+  heartbeatInterval?: number;
+  heartbeatTimeout?: number;
+  hiddenGracePeriod?: number;
+  random?: () => number;
+}
+
+const OPEN = 1;
+
+export class RealtimeConnection {
+  // Not connecting until start()
+  private current: ConnectionState = 'suspended';
+  private socket: WebSocketLike | null = null;
+  private generation = 0;
+  private attempt = 0;
+  private retryTimer: ReturnType<typeof setTimeout> | null = null;
+  private heartbeatTimer: ReturnType<typeof setInterval> | null = null;
+  private hiddenTimer: ReturnType<typeof setTimeout> | null = null;
+  private lastMessageAt = 0;
+  private pingId = 0;
+  private started = false;
+
+  // Listeners per topic; the topic is subscribed while it has any
+  private topics = new Map<string, Set<MessageListener>>();
+  private messageListeners = new Set<MessageListener>();
+  private stateListeners = new Set<StateListener>();
+
+  private readonly options: Required<Omit<RealtimeConnectionOptions, 'prepare'>> &
+    Pick<RealtimeConnectionOptions, 'prepare'>;
+
+  constructor(options: RealtimeConnectionOptions) {
+    this.options = {
+      createSocket: url => new WebSocket(url) as unknown as WebSocketLike,
+      baseDelay: 1000,
+      maxDelay: 30000,
+      heartbeatInterval: 25000,
+      heartbeatTimeout: 10000,
+      hiddenGracePeriod: 15000,
+      random: Math.random,
+      ...options,
+    };
+  }
+
+  get state(): ConnectionState {
+    return this.current;
+  }
+
+  // Start connecting (idempotent) and follow page visibility/connectivity
+  start(): void {
+    if (this.started || this.current === 'closed') {
+      return;
+    }
+    this.started = true;
+
+    if (typeof document !== 'undefined') {
+      document.addEventListener('visibilitychange', this.handleVisibility);
+    }
+    if (typeof window !== 'undefined') {
+      window.addEventListener('online', this.handleOnline);
+      window.addEventListener('offline', this.handleOffline);
+    }
+
+    if (!this.isHidden() && !this.isOffline()) {
+      this.open();
+    }
+  }
+
+  close(): void {
+    this.teardown();
+    if (this.hiddenTimer) {
+      clearTimeout(this.hiddenTimer);
+      this.hiddenTimer = null;
+    }
+    this.setState('closed');
+
+    if (typeof document !== 'undefined') {
+      document.removeEventListener('visibilitychange', this.handleVisibility);
+    }
+    if (typeof window !== 'undefined') {
+      window.removeEventListener('online', this.handleOnline);
+      window.removeEventListener('offline', this.handleOffline);
+    }
+    this.topics.clear();
+    this.messageListeners.clear();
+    this.stateListeners.clear();
+  }
+
+  // Receive messages published on `topic`. Returns the unsubscribe function.
+  subscribe(topic: string, listener: MessageListener): () => void {
+    let listeners = this.topics.get(topic);
+    if (!listeners) {
+      listeners = new Set();
+      this.topics.set(topic, listeners);
+      this.send({ type: 'SUBSCRIBE', topics: [topic] });
+    }
+    listeners.add(listener);
+
+    return () => {
+      const current = this.topics.get(topic);
+      if (!current || !current.delete(listener) || current.size > 0) {
+        return;
+      }
+      this.topics.delete(topic);
+      this.send({ type: 'UNSUBSCRIBE', topics: [topic] });
+    };
+  }
+
+  // Every message, whatever the topic (e.g. RESYNC, presence)
+  onMessage(listener: MessageListener): () => void {
+    this.messageListeners.add(listener);
+    return () => {
+      this.messageListeners.delete(listener);
+    };
+  }
+
+  onStateChange(listener: StateListener): () => void {
+    this.stateListeners.add(listener);
+    return () => {
+      this.stateListeners.delete(listener);
+    };
+  }
+
+  // Send a client message now; returns false when not connected
+  send(message: ClientMessage): boolean {
+    if (!this.socket || this.current !== 'connected' || this.socket.readyState !== OPEN) {
+      return false;
+    }
+    this.socket.send(JSON.stringify(message));
+    return true;
+  }
+
+  // Skip the backoff wait (e.g. a "Reconnect" button)
+  reconnectNow(): void {
+    if (this.current === 'closed' || this.current === 'connected' || this.current === 'connecting') {
+      return;
+    }
+    this.attempt = 0;
+    this.open();
+  }
+
+  private open(): void {
+    this.teardown();
+    const generation = ++this.generation;
+    this.setState('connecting');
+
+    const prepare = this.options.prepare ? this.options.prepare() : Promise.resolve();
+    prepare.then(
+      () => {
+        if (generation === this.generation) {
+          this.openSocket(generation);
+        }
+      },
+      () => {
+        if (generation === this.generation) {
+          this.scheduleReconnect();
+        }
+      }
+    );
+  }
+
+  private openSocket(generation: number): void {
+    let socket: WebSocketLike;
+    try {
+      socket = this.options.createSocket(this.options.url);
+    } catch (error) {
+      this.scheduleReconnect();
+      return;
+    }
+    this.socket = socket;
+
+    socket.onopen = () => {
+      if (generation !== this.generation) {
+        return;
+      }
+      this.attempt = 0;
+      this.lastMessageAt = Date.now();
+      this.setState('connected');
+      if (this.topics.size > 0) {
+        this.send({ type: 'SUBSCRIBE', topics: Array.from(this.topics.keys()) });
+      }
+      this.startHeartbeat(generation);
+    };
+
+    socket.onmessage = event => {
+      if (generation !== this.generation) {
+        return;
+      }
+      this.lastMessageAt = Date.now();
+      let message: WebSocketMessage;
+      try {
+        message = JSON.parse(String(event.data));
+      } catch (error) {
+        return;
+      }
+      this.dispatch(message);
+    };
+
+    socket.onclose = () => {
+      if (generation === this.generation) {
+        this.socket = null;
+        this.scheduleReconnect();
+      }
+    };
+
+    // onclose always follows; reconnecting happens there
+    socket.onerror = () => undefined;
+  }
+
+  private dispatch(message: WebSocketMessage): void {
+    if (message.type === 'PONG') {
+      return;
+    }
+    this.messageListeners.forEach(listener => listener(message));
+
+    // Like the gateway, deliver each message once per listener
+    const topics = messageTopics(message);
+    const delivered = new Set<MessageListener>();
+    topics.forEach(topic => {
+      const listeners = this.topics.get(topic);
+      if (listeners) {
+        listeners.forEach(listener => {
+          if (!delivered.has(listener)) {
+            delivered.add(listener);
+            listener(message);
+          }
+        });
+      }
+    });
+  }
+
+  private scheduleReconnect(): void {
+    this.teardown();
+    if (this.current === 'closed') {
+      return;
+    }
+    if (this.isHidden() || this.isOffline()) {
+      this.setState('suspended');
+      return;
+    }
+
+    const delay = backoffDelay(this.attempt++, this.options.baseDelay, this.options.maxDelay, this.options.random);
+    this.setState('reconnecting');
+    this.retryTimer = setTimeout(() => {
+      this.retryTimer = null;
+      this.open();
+    }, delay);
+  }
+
+  private startHeartbeat(generation: number): void {
+    const { heartbeatInterval, heartbeatTimeout } = this.options;
+    this.heartbeatTimer = setInterval(() => {
+      if (generation !== this.generation || !this.socket) {
+        return;
+      }
+      if (Date.now() - this.lastMessageAt > heartbeatInterval + heartbeatTimeout) {
+        // Half-open connection: nothing came back, not even PONGs
+        this.socket.close(4000, 'heartbeat timeout');
+        this.socket = null;
+        this.scheduleReconnect();
+        return;
+      }
+      this.send({ type: 'PING', id: String(++this.pingId) });
+    }, heartbeatInterval);
+  }
+
+  // Stop timers and drop the socket without triggering a reconnect
+  private teardown(): void {
+    this.generation++;
+    if (this.retryTimer) {
+      clearTimeout(this.retryTimer);
+      this.retryTimer = null;
+    }
+    if (this.heartbeatTimer) {
+      clearInterval(this.heartbeatTimer);
+      this.heartbeatTimer = null;
+    }
+    if (this.socket) {
+      const socket = this.socket;
+      this.socket = null;
+      socket.onopen = socket.onmessage = socket.onclose = socket.onerror = null;
+      socket.close(1000, 'client teardown');
+    }
+  }
+
+  private setState(state: ConnectionState): void {
+    if (this.current === state) {
+      return;
+    }
+    this.current = state;
+    this.stateListeners.forEach(listener => listener(state));
+  }
+
+  private isHidden(): boolean {
+    return typeof document !== 'undefined' && document.hidden;
+  }
+
+  private isOffline(): boolean {
+    return typeof navigator !== 'undefined' && navigator.onLine === false;
+  }
+
+  private handleVisibility = () => {
+    if (this.current === 'closed') {
+      return;
+    }
+    if (this.isHidden()) {
+      if (!this.hiddenTimer) {
+        this.hiddenTimer = setTimeout(() => {
+          this.hiddenTimer = null;
+          if (this.isHidden()) {
+            this.teardown();
+            this.setState('suspended');
+          }
+        }, this.options.hiddenGracePeriod);
+      }
+      return;
+    }
+
+    if (this.hiddenTimer) {
+      clearTimeout(this.hiddenTimer);
+      this.hiddenTimer = null;
+    }
+    if (this.current === 'suspended' && !this.isOffline()) {
+      this.attempt = 0;
+      this.open();
+    }
+  };
+
+  private handleOnline = () => {
+    if (this.current === 'suspended' || this.current === 'reconnecting') {
+      this.reconnectNow();
+    }
+  };
+
+  private handleOffline = () => {
+    if (this.current === 'reconnecting') {
+      this.teardown();
+      this.setState('suspended');
+    }
+  };
+}
+
+// The topics the gateway published `message` on (see server/realtime.ts;
+// not imported, as that module pulls in ws)
+function messageTopics(message: WebSocketMessage): string[] {
+  const payload = message.payload || {};
+  const postId: unknown = payload.postId || (payload.post && payload.post.id);
+  const post = typeof postId === 'string' ? [`post:${postId}`] : [];
+
+  switch (message.type) {
+    case 'POST_CREATED':
+      return ['feed'];
+    case 'POST_LIKED':
+    case 'POST_UPDATED':
+    case 'POST_DELETED':
+      return ['feed'].concat(post);
+    case 'USER_TYPING':
+    case 'COMMENT_ADDED':
+      return post;
+    case 'USER_PRESENCE':
+      return ['presence'];
+    default:
+      return [];
+  }
+}
+
+let shared: RealtimeConnection | null = null;
+
+// The page-wide connection to /api/realtime (browser only)
+export function getRealtimeConnection(userId: string): RealtimeConnection {
+  if (!shared || shared.state === 'closed') {
+    const protocol = window.location.protocol === 'https:' ? 'wss:' : 'ws:';
+    shared = new RealtimeConnection({
+      url: `${protocol}//${window.location.host}/api/realtime?userId=${encodeURIComponent(userId)}`,
+      // Make sure the gateway is attached to the server before upgrading
+      prepare: () =>
+        fetch('/api/realtime').then(response => {
+          if (!response.ok) {
+            throw new Error(`Realtime unavailable: ${response.status}`);
+          }
+        }),
+    });
+  }
+  shared.start();
+  return shared;
+}
@@ -0,0 +1,353 @@
+import { useCallback, useEffect, useLayoutEffect, useMemo, useReducer, useRef, useState } from 'react';
+
+// Windowed rendering for long lists with variable-height rows.
+//
+// RowLayout keeps row heights in a Fenwick tree, so the offset of a row and
+// the row at a scroll offset are O(log n) lookups and a new measurement is an
+// O(log n) update. Heights are cached by key (measured, or estimated until the
+// row has been on screen), so they survive re-ordering and filtering. The
+// cache can be shared by several layouts; heights of rows that left the list
+// are kept up to `maxDetached`.
+
+export class RowLayout {
+  private keys: string[] = [];
+  private indexByKey = new Map<string, number>();
+  private heights = new Float64Array(0);
+  private tree = new Float64Array(1);
+
+  constructor(
+    private readonly measured = new Map<string, number>(),
+    private readonly maxDetached = 1000
+  ) {}
+
+  get count(): number {
+    return this.keys.length;
+  }
+
+  get totalHeight(): number {
+    return this.offsetOf(this.keys.length);
+  }
+
+  keyAt(index: number): string | undefined {
+    return this.keys[index];
+  }
+
+  indexOf(key: string): number {
+    const index = this.indexByKey.get(key);
+    return index === undefined ? -1 : index;
+  }
+
+  // Replace the row order; unmeasured rows use `estimate(index)`. O(n).
+  setKeys(keys: string[], estimate: (index: number) => number): void {
+    const n = keys.length;
+    this.keys = keys;
+    this.indexByKey = new Map();
+    this.heights = new Float64Array(n);
+    this.tree = new Float64Array(n + 1);
+
+    for (let i = 0; i < n; i++) {
+      this.indexByKey.set(keys[i], i);
+      const measured = this.measured.get(keys[i]);
+      this.heights[i] = measured === undefined ? estimate(i) : measured;
+      this.tree[i + 1] = this.heights[i];
+    }
+
+    // Linear-time Fenwick build
+    for (let i = 1; i <= n; i++) {
+      const parent = i + (i & -i);
+      if (parent <= n) {
+        this.tree[parent] += this.tree[i];
+      }
+    }
+  }
+
+  // Record a measured height. Returns the change (0 when nothing moved).
+  setHeight(key: string, height: number): number {
+    this.measured.set(key, height);
+
+    const index = this.indexByKey.get(key);
+    return index === undefined ? 0 : this.resize(index, height);
+  }
+
+  // Take heights measured into the shared cache since setKeys (e.g. by the
+  // layout this one replaces). Returns whether anything moved.
+  syncMeasured(): boolean {
+    let moved = false;
+    for (let i = 0; i < this.keys.length; i++) {
+      const height = this.measured.get(this.keys[i]);
+      if (height !== undefined && this.resize(i, height) !== 0) {
+        moved = true;
+      }
+    }
+    return moved;
+  }
+
+  // Past the cap, forget every row that is not in this list
+  pruneMeasured(): void {
+    if (this.measured.size > this.keys.length + this.maxDetached) {
+      this.measured.forEach((_, key) => {
+        if (!this.indexByKey.has(key)) {
+          this.measured.delete(key);
+        }
+      });
+    }
+  }
+
+  private resize(index: number, height: number): number {
+    const delta = height - this.heights[index];
+    if (delta === 0) {
+      return 0;
+    }
+
+    this.heights[index] = height;
+    for (let i = index + 1; i < this.tree.length; i += i & -i) {
+      this.tree[i] += delta;
+    }
+    return delta;
+  }
+
+  // Distance from the top of the list to the top of row `index`
+  offsetOf(index: number): number {
+    let sum = 0;
+    for (let i = Math.min(index, this.keys.length); i > 0; i -= i & -i) {
+      sum += this.tree[i];
+    }
+    return sum;
+  }
+
+  // Row covering `offset` (clamped to the list)
+  indexAt(offset: number): number {
+    const n = this.keys.length;
+    if (n === 0 || offset <= 0) {
+      return 0;
+    }
+
+    let index = 0;
+    let remaining = offset;
+    let step = 1;
+    while (step * 2 <= n) {
+      step *= 2;
+    }
+
+    // Binary lifting: largest prefix whose total height is <= offset
+    for (; step > 0; step >>= 1) {
+      const next = index + step;
+      if (next <= n && this.tree[next] <= remaining) {
+        index = next;
+        remaining -= this.tree[next];
+      }
+    }
+    return Math.min(index, n - 1);
+  }
+}
+
+export interface WindowedListOptions<T> {
+  items: T[];
+  getKey: (item: T) => string;
+  estimateHeight: (item: T) => number;
+  // Extra pixels rendered above and below the viewport
+  overscan?: number;
+}
+
+export interface WindowedList {
+  containerRef: (element: HTMLElement | null) => void;
+  measureRef: (key: string) => (element: HTMLElement | null) => void;
+  start: number;
+  end: number;
+  paddingTop: number;
+  paddingBottom: number;
+}
+
+// Rows rendered before the viewport has been measured (first paint / SSR)
+const INITIAL_ROWS = 10;
+
+const useIsomorphicLayoutEffect = typeof window !== 'undefined' ? useLayoutEffect : useEffect;
+
+// Window-scrolled virtualization: only rows intersecting the viewport plus
+// `overscan` are mounted. Row heights are measured with a ResizeObserver,
+// and the first visible row is kept in place when rows above it are
+// inserted or change height, so prepending posts does not move the feed.
+export function useWindowedList<T>({
+  items,
+  getKey,
+  estimateHeight,
+  overscan = 800,
+}: WindowedListOptions<T>): WindowedList {
+  // Measured heights outlive layouts; each key list gets a layout of its own
+  const [measured] = useState(() => new Map<string, number>());
+  const container = useRef<HTMLElement | null>(null);
+  const [range, setRange] = useState({ start: 0, end: Math.min(items.length, INITIAL_ROWS) });
+  const [, relayout] = useReducer((count: number) => count + 1, 0);
+
+  // First row inside the viewport and its offset, used as the scroll anchor
+  const anchor = useRef<{ key: string; offset: number } | null>(null);
+  const frame = useRef<number | null>(null);
+
+  // Offsets are built with the key list, so the first pass (and SSR) already
+  // renders the right rows. Render only reads `measured`: a layout React
+  // discards never reaches the observer, which writes to the committed one.
+  const layout = useMemo(() => {
+    const next = new RowLayout(measured);
+    next.setKeys(items.map(getKey), index => estimateHeight(items[index]));
+    return next;
+  }, [measured, items, getKey, estimateHeight]);
+  const committed = useRef(layout);
+
+  const updateRange = useCallback(() => {
+    const element = container.current;
+    const layout = committed.current;
+    if (!element) {
+      return;
+    }
+
+    const listTop = element.getBoundingClientRect().top + window.scrollY;
+    const viewTop = window.scrollY - listTop;
+    const viewBottom = viewTop + window.innerHeight;
+
+    const first = layout.indexAt(viewTop);
+    const start = layout.indexAt(viewTop - overscan);
+    const end = Math.min(layout.count, layout.indexAt(viewBottom + overscan) + 1);
+
+    const firstKey = layout.keyAt(first);
+    anchor.current = firstKey === undefined ? null : { key: firstKey, offset: layout.offsetOf(first) };
+
+    setRange(previous =>
+      previous.start === start && previous.end === end ? previous : { start, end }
+    );
+  }, [overscan]);
+
+  const scheduleUpdate = useCallback(() => {
+    if (frame.current === null) {
+      frame.current = window.requestAnimationFrame(() => {
+        frame.current = null;
+        updateRange();
+      });
+    }
+  }, [updateRange]);
+
+  // New item list: commit its layout, take heights measured since it was
+  // built, then scroll so the anchor row stays where it was on screen (the
+  // anchor still holds the previous offsets)
+  useIsomorphicLayoutEffect(() => {
+    committed.current = layout;
+    layout.pruneMeasured();
+    if (layout.syncMeasured()) {
+      relayout();
+    }
+
+    const previous = anchor.current;
+    if (previous) {
+      const index = layout.indexOf(previous.key);
+      if (index !== -1) {
+        const shift = layout.offsetOf(index) - previous.offset;
+        if (shift !== 0) {
+          window.scrollBy(0, shift);
+        }
+      }
+    }
+    updateRange();
+  }, [layout, updateRange]);
+
+  useEffect(() => {
+    window.addEventListener('scroll', scheduleUpdate, { passive: true });
+    window.addEventListener('resize', scheduleUpdate);
+    return () => {
+      window.removeEventListener('scroll', scheduleUpdate);
+      window.removeEventListener('resize', scheduleUpdate);
+      if (frame.current !== null) {
+        window.cancelAnimationFrame(frame.current);
+        frame.current = null;
+      }
+    };
+  }, [scheduleUpdate]);
+
+  // One observer for all mounted rows
+  const observer = useMemo(() => {
+    if (typeof ResizeObserver === 'undefined') {
+      return null;
+    }
+    return new ResizeObserver(entries => {
+      const layout = committed.current;
+      let changed = false;
+      let shiftAbove = 0;
+      const anchorIndex = anchor.current ? layout.indexOf(anchor.current.key) : -1;
+
+      entries.forEach(entry => {
+        const element = entry.target as HTMLElement;
+        const key = element.dataset.rowKey;
+        // Detached rows report 0; keep their last real height
+        if (!key || !element.isConnected) {
+          return;
+        }
+        const delta = layout.setHeight(key, element.getBoundingClientRect().height);
+        if (delta !== 0) {
+          changed = true;
+          if (anchorIndex !== -1 && layout.indexOf(key) < anchorIndex) {
+            shiftAbove += delta;
+          }
+        }
+      });
+
+      if (shiftAbove !== 0) {
+        window.scrollBy(0, shiftAbove);
+      }
+      if (changed) {
+        relayout();
+        scheduleUpdate();
+      }
+    });
+  }, [scheduleUpdate]);
+
+  useEffect(() => () => observer?.disconnect(), [observer]);
+
+  // Stable per-key ref callbacks so React does not detach/reattach rows
+  const rowRefs = useRef(new Map<string, (element: HTMLElement | null) => void>());
+  const observed = useRef(new Map<string, HTMLElement>());
+
+  const measureRef = useCallback(
+    (key: string) => {
+      let ref = rowRefs.current.get(key);
+      if (!ref) {
+        ref = (element: HTMLElement | null) => {
+          const previous = observed.current.get(key);
+          if (previous && observer) {
+            observer.unobserve(previous);
+          }
+          if (element) {
+            element.dataset.rowKey = key;
+            observed.current.set(key, element);
+            observer?.observe(element);
+          } else {
+            observed.current.delete(key);
+            rowRefs.current.delete(key);
+          }
+        };
+        rowRefs.current.set(key, ref);
+      }
+      return ref;
+    },
+    [observer]
+  );
+
+  const containerRef = useCallback(
+    (element: HTMLElement | null) => {
+      container.current = element;
+      if (element) {
+        scheduleUpdate();
+      }
+    },
+    [scheduleUpdate]
+  );
+
+  const start = Math.min(range.start, layout.count);
+  const end = Math.min(range.end, layout.count);
+
+  return {
+    containerRef,
+    measureRef,
+    start,
+    end,
+    paddingTop: layout.offsetOf(start),
+    paddingBottom: Math.max(0, layout.totalHeight - layout.offsetOf(end)),
+  };
+}